@@ -0,0 +1,14 @@
+#pragma once
+
+// Correctness checks run by `physics_bench --check`. Each prints one
+// line to stdout and returns whether it passed.
+
+enum class BenchCheck {
+    Simd,     // every circle kernel matches the scalar one on boundary pairs
+    Teleport  // a sleeping stack falls when its floor is moved away
+};
+
+const char* getBenchCheckName(BenchCheck check);
+bool parseBenchCheck(const char* name, BenchCheck& check);
+
+bool runBenchCheck(BenchCheck check);
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include "physics/physicsWorld.h"
+
+// Render-less scenes for physics_bench. Everything is laid out from a
+// fixed seed, so a scene with the same parameters is the same
+// simulation on every run and every machine.
+//
+// Units match the SFML demos: pixels, 800 px/s^2 gravity, 1/60 s steps.
+
+enum class BenchScene {
+    Balls,  // circles thrown around a closed box
+    Boxes,  // the same with boxes
+    Pile,   // a grid of circles and boxes dropped into a container
+    Rain,   // bodies spawned over time above a floor with obstacles
+    Stacks  // columns of boxes resting on a floor
+};
+
+struct BenchSceneConfig {
+    BenchScene scene = BenchScene::Pile;
+    uint32_t bodyCount = 1000;
+    uint32_t seed = 1;
+};
+
+const char* getBenchSceneName(BenchScene scene);
+bool parseBenchScene(const char* name, BenchScene& scene);
+
+// Builds the scene into an empty world. Rain starts empty and fills
+// up through updateBenchScene.
+void buildBenchScene(PhysicsWorld& world, const BenchSceneConfig& config);
+
+// Called before every step; only Rain does anything.
+void updateBenchScene(PhysicsWorld& world, const BenchSceneConfig& config, uint32_t step);
@@ -1,20 +1,19 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include <deque>
+#include <vector>
 
 #include "math/Vec2.h"
 #include "physics/physicsWorld.h"
 
 struct Ball {
-    RigidBody body;
-    CircleCollider collider;
+    BodyHandle body;
     sf::CircleShape shape;
 };
 
 void addBall(
     PhysicsWorld& world,
-    std::deque<Ball>& balls,
+    std::vector<Ball>& balls,
     Vec2 position,
     float radius,
     float mass,
@@ -24,14 +23,13 @@ void addBall(
 );
 
 struct Rectangle {
-    RigidBody body;
-    BoxCollider collider;
+    BodyHandle body;
     sf::RectangleShape shape;
 };
 
 void addRectangle(
     PhysicsWorld& world,
-    std::deque<Rectangle>& rectangles,
+    std::vector<Rectangle>& rectangles,
     Vec2 position,
     float width,
     float height,
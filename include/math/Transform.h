@@ -0,0 +1,26 @@
+#pragma once
+#include <cmath>
+#include "math/trig.h"
+#include "math/Vec2.h"
+
+// Rigid transform: rotation by angle (cos/sin cached), then translation.
+struct Transform {
+    Vec2 p;
+    float c = 1.f;
+    float s = 0.f;
+
+    Transform() = default;
+    Transform(const Vec2& position, float angle)
+        : p(position) { sinCos(angle, s, c); }
+
+    Vec2 rotate(const Vec2& v) const {
+        return { c * v.x - s * v.y, s * v.x + c * v.y };
+    }
+    Vec2 invRotate(const Vec2& v) const {
+        return { c * v.x + s * v.y, -s * v.x + c * v.y };
+    }
+
+    // local -> world and back
+    Vec2 apply(const Vec2& v) const { return rotate(v) + p; }
+    Vec2 applyInverse(const Vec2& v) const { return invRotate(v - p); }
+};
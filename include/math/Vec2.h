@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include "math/trig.h"
 
 struct Vec2 {
     float x, y;
@@ -60,8 +61,8 @@ struct Vec2 {
     }
 
     Vec2 rotated(float angle) const {
-        float c = std::cos(angle);
-        float s = std::sin(angle);
+        float s, c;
+        sinCos(angle, s, c);
         return {
             x * c - y * s,
             x * s + y * c
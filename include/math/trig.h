@@ -0,0 +1,52 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+// Sine and cosine for rotations.
+//
+// std::sin/std::cos are whatever the platform's libm makes of them, so
+// two machines can disagree in the last bit. Deterministic builds use
+// the version below instead: a Cody-Waite reduction to [-pi/4, pi/4]
+// and Taylor polynomials, all in double with plain + - * (correctly
+// rounded everywhere once FMA contraction is off), then rounded to
+// float. Accurate to float precision for any angle a body reaches.
+#ifndef PHYSICS_DETERMINISTIC
+    #define PHYSICS_DETERMINISTIC 0
+#endif
+
+#if PHYSICS_DETERMINISTIC && defined(__FAST_MATH__)
+    #error "PHYSICS_DETERMINISTIC builds cannot use -ffast-math"
+#endif
+
+// x87 rounds to its register precision, not to float or double.
+#if PHYSICS_DETERMINISTIC && ((defined(__i386__) && !defined(__SSE2_MATH__)) || \
+                              (defined(_M_IX86) && _M_IX86_FP < 2))
+    #error "PHYSICS_DETERMINISTIC builds on 32-bit x86 need SSE2 math (-msse2 -mfpmath=sse)"
+#endif
+
+inline void sinCos(float angle, float& s, float& c)
+{
+#if PHYSICS_DETERMINISTIC
+    const double TWO_OVER_PI = 0.63661977236758134308;
+    const double PIO2_HI = 1.57079632673412561417e+00; // first 33 bits of pi/2
+    const double PIO2_LO = 6.07710050650619224932e-11; // pi/2 - PIO2_HI
+
+    double x = angle;
+    double q = std::floor(x * TWO_OVER_PI + 0.5);
+    double r = (x - q * PIO2_HI) - q * PIO2_LO;
+    double r2 = r * r;
+
+    double sr = r + r * r2 * (-1.0 / 6 + r2 * (1.0 / 120 + r2 * (-1.0 / 5040 + r2 * (1.0 / 362880))));
+    double cr = 1.0 + r2 * (-0.5 + r2 * (1.0 / 24 + r2 * (-1.0 / 720 + r2 * (1.0 / 40320 + r2 * (-1.0 / 3628800)))));
+
+    switch (static_cast<int64_t>(q) & 3) {
+        case 0:  s = static_cast<float>(sr);  c = static_cast<float>(cr);  break;
+        case 1:  s = static_cast<float>(cr);  c = static_cast<float>(-sr); break;
+        case 2:  s = static_cast<float>(-sr); c = static_cast<float>(-cr); break;
+        default: s = static_cast<float>(-cr); c = static_cast<float>(sr);  break;
+    }
+#else
+    s = std::sin(angle);
+    c = std::cos(angle);
+#endif
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include "math/Vec2.h"
+
+struct AABB {
+    Vec2 min;
+    Vec2 max;
+
+    bool overlaps(const AABB& other) const {
+        if (max.x < other.min.x) return false;
+        if (min.x > other.max.x) return false;
+        if (max.y < other.min.y) return false;
+        if (min.y > other.max.y) return false;
+        return true;
+    }
+
+    bool contains(const AABB& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y &&
+               max.x >= other.max.x && max.y >= other.max.y;
+    }
+
+    float perimeter() const {
+        return 2.f * ((max.x - min.x) + (max.y - min.y));
+    }
+
+    // Slab test of the segment p1 + (p2 - p1) * t for t in [0, maxFraction].
+    bool intersectsSegment(const Vec2& p1, const Vec2& p2, float maxFraction) const {
+        Vec2 d = p2 - p1;
+        float tMin = 0.f;
+        float tMax = maxFraction;
+
+        const float o[2]  = { p1.x, p1.y };
+        const float dd[2] = { d.x, d.y };
+        const float lo[2] = { min.x, min.y };
+        const float hi[2] = { max.x, max.y };
+
+        for (int axis = 0; axis < 2; axis++) {
+            if (std::abs(dd[axis]) < 1e-12f) {
+                if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+                continue;
+            }
+            float inv = 1.f / dd[axis];
+            float t1 = (lo[axis] - o[axis]) * inv;
+            float t2 = (hi[axis] - o[axis]) * inv;
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+        return true;
+    }
+
+    static AABB combine(const AABB& a, const AABB& b) {
+        return {
+            { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y) },
+            { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y) }
+        };
+    }
+};
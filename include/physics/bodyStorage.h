@@ -0,0 +1,129 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "math/Vec2.h"
+#include "physics/polygon.h"
+#include "physics/rigidBody.h"
+#include "physics/snapshot.h"
+
+enum class ColliderType {
+    Circle,
+    Polygon
+};
+constexpr uint32_t COLLIDER_TYPE_COUNT = 2;
+
+// Reference to a body owned by a PhysicsWorld: a slot and the slot's
+// generation. Bodies move around in storage as others are destroyed,
+// but keep their slot; a destroyed body's slot is reused later with a
+// new generation, so stale handles are told apart from live ones
+// (PhysicsWorld::isValid). isValid() here only checks for the null
+// handle.
+struct BodyHandle {
+    static constexpr uint32_t INVALID = UINT32_MAX;
+
+    uint32_t id = INVALID; // slot
+    uint32_t generation = 0;
+
+    bool isValid() const { return id != INVALID; }
+    bool operator==(const BodyHandle& o) const { return id == o.id && generation == o.generation; }
+    bool operator!=(const BodyHandle& o) const { return !(*this == o); }
+};
+
+// World-owned body data, one contiguous array per field (structure of
+// arrays), so integration and the solver stream through memory instead
+// of chasing pointers into caller-owned render objects.
+//
+// halfExtents is {radius, radius} for circles. Polygons (boxes included)
+// keep their vertices in the polygons pool and store their bounding
+// radius there instead, so pos +/- halfExtents bounds any rotation.
+//
+// Bodies are dense: removing one moves the last body into its place.
+// Handles go through the slot table, which follows every move.
+struct BodyStorage {
+    // ---------- STATE ----------
+    std::vector<Vec2>  position;
+    std::vector<Vec2>  velocity;
+    std::vector<Vec2>  force;
+    std::vector<float> rotation;
+    std::vector<float> angularVelocity;
+
+    // ---------- INTERPOLATION ----------
+    // State at the start of the last step.
+    std::vector<Vec2>  previousPosition;
+    std::vector<float> previousRotation;
+
+    // ---------- MASS ----------
+    std::vector<float> mass;
+    std::vector<float> invMass;
+    std::vector<float> invInertia;
+
+    // ---------- SHAPE ----------
+    std::vector<ColliderType> type;
+    std::vector<Vec2>  halfExtents;
+    std::vector<float> restitution;
+    std::vector<float> staticFriction;
+    std::vector<float> dynamicFriction;
+    std::vector<uint32_t> polygon; // index into polygons, NO_POLYGON for circles
+    std::vector<Polygon>  polygons;
+    std::vector<uint32_t> polygonOwner; // body index of each polygon
+
+    // ---------- SLEEP ----------
+    // Static bodies are never awake; sleeping bodies skip integration
+    // and only re-enter the solver once something awake touches them.
+    std::vector<uint8_t> awake;
+    std::vector<float>   sleepTime;
+
+    // ---------- CONTINUOUS COLLISION ----------
+    std::vector<uint8_t> bullet;
+
+    // ---------- BROADPHASE ----------
+    std::vector<int32_t> proxyId;
+
+    // ---------- HANDLES ----------
+    std::vector<uint32_t> slot;           // body index -> slot
+    std::vector<uint32_t> slotIndex;      // slot -> body index, NO_INDEX when free
+    std::vector<uint32_t> slotGeneration;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> retiredSlots;   // freed, not reusable yet
+
+    static constexpr uint32_t NO_POLYGON = UINT32_MAX;
+    static constexpr uint32_t NO_INDEX = UINT32_MAX;
+
+    size_t size() const { return position.size(); }
+
+    // Appends a body and returns its index. Polygons are copied into the
+    // pool.
+    uint32_t push(
+        const RigidBody& body,
+        ColliderType shape,
+        const Vec2& extents,
+        float bodyRestitution,
+        float bodyStaticFriction,
+        float bodyDynamicFriction,
+        const Polygon* bodyPolygon = nullptr
+    );
+
+    // Removes body `index` by moving the last body into its place, and
+    // returns where the moved body used to be (`index` itself when it
+    // was the last one). The slot is retired, not freed, until
+    // releaseRetiredSlots.
+    uint32_t remove(uint32_t index);
+
+    // Makes retired slots reusable.
+    void releaseRetiredSlots();
+
+    // Every array, handles included.
+    void save(SnapshotWriter& out) const;
+    bool restore(SnapshotReader& in);
+
+    bool contains(BodyHandle handle) const {
+        return handle.id < slotIndex.size() &&
+               slotIndex[handle.id] != NO_INDEX &&
+               slotGeneration[handle.id] == handle.generation;
+    }
+    uint32_t indexOf(BodyHandle handle) const { return slotIndex[handle.id]; }
+    BodyHandle handleOf(uint32_t index) const { return { slot[index], slotGeneration[slot[index]] }; }
+
+private:
+    void removePolygon(uint32_t polygonIndex);
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "physics/aabb.h"
+#include "physics/frameArena.h"
+
+enum class BroadphaseType {
+    BruteForce,     // every i<j pair, every solver pass
+    SweepAndPrune,
+    SpatialHashGrid,
+    DynamicTree
+};
+
+// Candidate pair of indices into PhysicsWorld's object list (a < b).
+struct BroadphasePair {
+    uint32_t a;
+    uint32_t b;
+};
+
+// Sort-and-sweep along the x axis.
+// The sorted order is kept between steps, so the insertion sort
+// only has to fix up the few proxies that moved past each other.
+class SweepAndPrune {
+public:
+    void findPairs(
+        const std::vector<AABB>& bounds,
+        FrameVector<BroadphasePair>& pairs
+    );
+
+private:
+    std::vector<uint32_t> order;
+};
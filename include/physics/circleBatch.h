@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/Vec2.h"
+
+// Batched circle-vs-circle overlap tests.
+//
+// Pairs are laid out as structure of arrays (centre of A, centre of B,
+// radius sum) so one instruction can test 4 (SSE2), 8 (AVX2) or 16
+// (AVX-512) pairs. The widest kernel the CPU supports is picked once at
+// runtime; other targets and CPUs use the scalar loop. Every kernel
+// gives the same answer as circleVsCircle.
+
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+SimdLevel detectSimdLevel();
+const char* getSimdLevelName(SimdLevel level);
+
+// Writes the index of every overlapping pair to hits, in ascending
+// order, and returns how many there were. hits must have room for
+// count entries.
+size_t circleOverlaps(
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t count,
+    uint32_t* hits
+);
+
+// Same, forcing a kernel. Levels above detectSimdLevel() fall back to
+// the best supported one.
+size_t circleOverlaps(
+    SimdLevel level,
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t count,
+    uint32_t* hits
+);
+
+// Reusable buffers for one run of circle pairs.
+struct CircleBatch {
+    std::vector<float> ax, ay;
+    std::vector<float> bx, by;
+    std::vector<float> radiusSum;
+    std::vector<uint32_t> hits;
+
+    size_t size() const { return ax.size(); }
+
+    void clear() {
+        ax.clear(); ay.clear();
+        bx.clear(); by.clear();
+        radiusSum.clear();
+        hits.clear();
+    }
+
+    void push(const Vec2& a, const Vec2& b, float sum) {
+        ax.push_back(a.x); ay.push_back(a.y);
+        bx.push_back(b.x); by.push_back(b.y);
+        radiusSum.push_back(sum);
+    }
+
+    // Fills hits with the indices of the overlapping pairs.
+    void findOverlaps() {
+        hits.resize(size());
+        size_t n = circleOverlaps(ax.data(), ay.data(), bx.data(), by.data(),
+            radiusSum.data(), size(), hits.data());
+        hits.resize(n);
+    }
+};
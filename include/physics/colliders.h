@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+#include "math/Vec2.h"
 
 struct CircleCollider {
     float radius = 0.f;
@@ -13,4 +15,13 @@ struct BoxCollider {
     float restitution = 0.5f;
     float staticFriction  = 0.4f;
     float dynamicFriction = 0.2f;
-};
\ No newline at end of file
+};
+
+// Convex hull of the given points, up to Polygon::MAX_VERTICES, in body
+// space. The body's position is moved onto the hull's centroid.
+struct PolygonCollider {
+    std::vector<Vec2> vertices;
+    float restitution = 0.5f;
+    float staticFriction  = 0.4f;
+    float dynamicFriction = 0.2f;
+};
@@ -1,18 +1,92 @@
 #pragma once
+#include <cstdint>
+#include "math/Transform.h"
 #include "math/Vec2.h"
-#include "physics/colliders.h"
+#include "physics/aabb.h"
+#include "physics/polygon.h"
+
+// Shapes are passed as plain geometry so the world's body arrays can be
+// fed in directly; halfExtents is {halfWidth, halfHeight}.
 
 bool circleVsCircle(
-    const Vec2& posA, const CircleCollider& a,
-    const Vec2& posB, const CircleCollider& b
+    const Vec2& posA, float radiusA,
+    const Vec2& posB, float radiusB
 );
 
 bool circleVsBox(
     const Vec2& circlePos, float radius,
-    const Vec2& boxPos, const BoxCollider& box
+    const Vec2& boxPos, const Vec2& halfExtents
 );
 
 bool AABBvsAABB(
-    const Vec2& posA, const BoxCollider& A,
-    const Vec2& posB, const BoxCollider& B
-);
\ No newline at end of file
+    const Vec2& posA, const Vec2& halfA,
+    const Vec2& posB, const Vec2& halfB
+);
+
+AABB computeAABB(const Vec2& pos, const Vec2& halfExtents);
+
+// ---------- CONTACT GEOMETRY ----------
+// Filled in when two shapes overlap: a shared normal pointing from the
+// first shape to the second and up to two contact points, each with its
+// own penetration and a feature id that stays the same while the same
+// pair of features keeps touching (used to match warm-start impulses).
+struct ContactGeometry {
+    static constexpr int MAX_POINTS = 2;
+
+    Vec2 normal;
+    int pointCount = 0;
+    Vec2 points[MAX_POINTS];
+    float penetration[MAX_POINTS] = {};
+    uint32_t id[MAX_POINTS] = {};
+};
+
+bool collideCircles(
+    const Vec2& posA, float radiusA,
+    const Vec2& posB, float radiusB,
+    ContactGeometry& contact
+);
+
+// Normal points from the circle to the polygon.
+bool collideCirclePolygon(
+    const Vec2& circlePos, float radius,
+    const Polygon& polygon, const Transform& xf,
+    ContactGeometry& contact
+);
+
+// SAT on the edge normals of both polygons, then the incident edge is
+// clipped against the side planes of the reference edge, giving one or
+// two contact points.
+bool collidePolygons(
+    const Polygon& polygonA, const Transform& xfA,
+    const Polygon& polygonB, const Transform& xfB,
+    ContactGeometry& contact
+);
+
+// Segment p1 -> p2 against a shape, ignoring hits beyond maxFraction.
+// On a hit, fraction is the position along the segment and normal
+// is the surface normal at the hit point. Segments starting inside
+// the shape report no hit.
+bool raycastCircle(
+    const Vec2& p1, const Vec2& p2, float maxFraction,
+    const Vec2& center, float radius,
+    float& fraction, Vec2& normal
+);
+
+bool raycastPolygon(
+    const Vec2& p1, const Vec2& p2, float maxFraction,
+    const Polygon& polygon, const Transform& xf,
+    float& fraction, Vec2& normal
+);
+
+// Whether a point lies inside (or on) the polygon.
+bool testPointPolygon(const Vec2& point, const Polygon& polygon, const Transform& xf);
+
+// Circle of the given radius moved from p1 to p2 against a polygon;
+// same conventions as the raycasts, with normal pointing from the
+// polygon to the circle. A circle sweeping another circle is a
+// raycastCircle against the sum of the radii.
+bool sweepCirclePolygon(
+    const Vec2& p1, const Vec2& p2, float radius, float maxFraction,
+    const Polygon& polygon, const Transform& xf,
+    float& fraction, Vec2& normal
+);
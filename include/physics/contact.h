@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "math/Vec2.h"
+#include "physics/snapshot.h"
+
+// Solver-ready contact, rebuilt by the narrowphase once per step.
+// Everything the velocity iterations need is copied in up front so the
+// solver streams through this array instead of the body storage.
+struct Contact {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t manifold = 0;   // index into ContactCache for this step
+    uint32_t id = 0;         // feature id, see ContactGeometry
+    uint8_t point = 0;       // slot in the manifold
+
+    Vec2 normal;             // a -> b
+    Vec2 rA;                 // contact point relative to a's centre
+    Vec2 rB;                 // contact point relative to b's centre
+    float penetration = 0.f;
+
+    float invMassA = 0.f;
+    float invMassB = 0.f;
+    float invInertiaA = 0.f;
+    float invInertiaB = 0.f;
+
+    float normalMass  = 0.f; // 1 / effective mass along the normal
+    float tangentMass = 0.f; // 1 / effective mass along the tangent
+    float velocityBias = 0.f; // restitution target
+
+    float staticFriction  = 0.f;
+    float dynamicFriction = 0.f;
+
+    float normalImpulse  = 0.f; // accumulated
+    float tangentImpulse = 0.f;
+    float pseudoImpulse  = 0.f; // split-impulse position pass, this step only
+};
+
+// Impulses of a touching pair, carried between steps for warm starting.
+// Points are matched to last step's by feature id, so an impulse stays
+// with the corner it was built up on when the other point drops out.
+struct ContactManifold {
+    static constexpr int MAX_POINTS = 2;
+
+    uint32_t a = 0;
+    uint32_t b = 0;
+
+    int pointCount = 0;
+    uint32_t id[MAX_POINTS] = {};
+    float normalImpulse[MAX_POINTS]  = {};
+    float tangentImpulse[MAX_POINTS] = {};
+
+    uint32_t stamp = 0; // last step the pair was touching
+};
+
+// Contact manifolds keyed by body pair, kept alive for as long as the
+// pair keeps touching. The world keys them by handle slot rather than
+// body index, since indices shift when bodies are destroyed.
+//
+// Manifolds sit in one dense pool (swap-and-pop on removal) and the
+// pair lookup is an open-addressing table in a flat array, so neither
+// allocates once they have grown to the scene's number of touching
+// pairs.
+class ContactCache {
+public:
+    // Returns the index of the pair's manifold, creating an empty one if
+    // needed. Indices stay valid until the next removeStale.
+    uint32_t find(uint32_t a, uint32_t b);
+
+    // Drops every manifold that was not touched during step `stamp`.
+    void removeStale(uint32_t stamp);
+
+    ContactManifold& operator[](uint32_t i) { return manifolds[i]; }
+    std::vector<ContactManifold>& getManifolds() { return manifolds; }
+    size_t size() const { return manifolds.size(); }
+    void clear();
+
+    // The pool and the lookup table as they are, so a restored cache
+    // hands out the same manifold indices.
+    void save(SnapshotWriter& out) const;
+    bool restore(SnapshotReader& in);
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    struct Slot {
+        uint64_t key = 0;
+        uint32_t manifold = EMPTY;
+    };
+
+    std::vector<ContactManifold> manifolds;
+    std::vector<Slot> slots; // power of two, at most half full
+
+    static uint64_t key(uint32_t a, uint32_t b) {
+        if (a > b) std::swap(a, b);
+        return (uint64_t(a) << 32) | b;
+    }
+
+    size_t home(uint64_t k) const;
+    size_t findSlot(uint64_t k) const; // the key's slot or the empty one ending its probe
+    void eraseSlot(size_t i);
+    void rehash(size_t slotCount);
+};
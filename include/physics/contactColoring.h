@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "physics/bodyStorage.h"
+#include "physics/contact.h"
+
+// Splits one island's contacts into colours so that no two contacts of
+// the same colour share a dynamic body. Static bodies don't count:
+// the solver never writes to them.
+//
+// Contacts of one colour can be solved concurrently, and solving the
+// colours one after another is still Gauss-Seidel, so a single big pile
+// keeps its convergence while spreading over every thread. Colouring is
+// greedy in contact order and does not depend on the thread count.
+class ContactColoring {
+public:
+    static constexpr uint32_t MAX_COLORS = 64;
+
+    // Reorders run[0, count) colour by colour, keeping the original
+    // order inside a colour. Both points of a manifold get one colour
+    // and stay next to each other. Contacts that found no free colour go
+    // to a final overflow group that has to be solved serially.
+    void build(const BodyStorage& bodies, Contact* run, size_t count);
+
+    // True when run[i] is the second point of the manifold before it.
+    static bool isSecondPoint(const Contact* run, size_t i) {
+        return i > 0 && run[i].point == 1 && run[i].manifold == run[i - 1].manifold;
+    }
+
+    // Colour c owns [colorStart[c], colorStart[c + 1]).
+    uint32_t getColorCount() const { return static_cast<uint32_t>(colorStart.size()) - 1; }
+    uint32_t getColorBegin(uint32_t c) const { return colorStart[c]; }
+    uint32_t getColorEnd(uint32_t c) const { return colorStart[c + 1]; }
+    bool isOverflow(uint32_t c) const { return hasOverflow && c + 1 == getColorCount(); }
+
+private:
+    std::vector<uint64_t> bodyColors; // bit c set: body already in colour c
+    std::vector<uint8_t> contactColor;
+    std::vector<uint32_t> colorStart;
+    std::vector<uint32_t> cursor;
+    std::vector<Contact> scratch;
+    bool hasOverflow = false;
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include "physics/bodyStorage.h"
+#include "physics/contact.h"
+
+// Sequential-impulse kernels over a run of prepared contacts.
+// They only read and write the bodies referenced by those contacts,
+// so runs that share no dynamic body can be solved independently.
+
+// Applies the impulses carried over from the previous step.
+void warmStartContacts(BodyStorage& bodies, const Contact* contacts, size_t count);
+
+// One Gauss-Seidel pass over the normal and friction impulses. The two
+// points of a manifold are solved together when they sit next to each
+// other in the run.
+void solveVelocityConstraints(BodyStorage& bodies, Contact* contacts, size_t count);
+
+// Soft contact for the substepped solver: a damped spring of
+// `hertz` and `dampingRatio` pushing penetration out over a substep of
+// length h, as bias velocity plus mass and impulse scaling.
+struct ContactSoftness {
+    float biasRate = 0.f;
+    float massScale = 1.f;
+    float impulseScale = 0.f;
+    float invH = 0.f;
+};
+
+ContactSoftness makeContactSoftness(float hertz, float dampingRatio, float h);
+
+// One pass for a substep, against where the bodies are now. With
+// useBias the contact also pushes out penetration beyond slop, softly;
+// without it (the relax pass) it only holds the restitution target.
+// Contacts that have moved apart allow the gap to close and no more.
+void solveSoftVelocityConstraints(
+    BodyStorage& bodies,
+    Contact* contacts, size_t count,
+    const ContactSoftness& softness,
+    float slop, bool useBias
+);
+
+// Split-impulse pass: accumulates pseudo-velocities (one per body) that
+// remove percent of the penetration beyond slop within the next dt
+// (invDt = 1 / dt). The caller integrates them into position once; the
+// real velocities never see them, so the correction adds no bounce.
+void solvePseudoVelocityConstraints(
+    const BodyStorage& bodies, Vec2* pseudoVelocity,
+    Contact* contacts, size_t count,
+    float percent, float slop, float invDt
+);
+
+// Baumgarte pass: pushes bodies apart by percent of the penetration left
+// over after the bodies moved since the narrowphase.
+void solvePositionConstraints(
+    BodyStorage& bodies,
+    const Contact* contacts, size_t count,
+    float percent, float slop
+);
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "physics/aabb.h"
+#include "physics/snapshot.h"
+
+// Dynamic bounding volume tree.
+// Leaves hold fattened AABBs so a moving body is only reinserted once it
+// leaves its fat box; inserts use a perimeter cost heuristic and every
+// modified ancestor is rebalanced with AVL-style rotations.
+class DynamicTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    float margin = 5.f; // fat AABB padding, world units
+
+    int32_t createProxy(const AABB& box, uint32_t userData);
+    void destroyProxy(int32_t proxyId);
+
+    // Returns true if the proxy had to be reinserted.
+    bool moveProxy(int32_t proxyId, const AABB& box);
+
+    const AABB& getFatAABB(int32_t proxyId) const { return nodes[proxyId].box; }
+    uint32_t getUserData(int32_t proxyId) const { return nodes[proxyId].userData; }
+    void setUserData(int32_t proxyId, uint32_t userData) { nodes[proxyId].userData = userData; }
+
+    int32_t getHeight() const;
+
+    // Nodes, root and free list; proxy ids stay valid across a restore.
+    void save(SnapshotWriter& out) const;
+    bool restore(SnapshotReader& in);
+
+    // callback(proxyId) -> bool, return false to stop the query.
+    template <typename Callback>
+    void query(const AABB& box, Callback&& callback) const;
+
+    // callback(proxyId, p1, p2, maxFraction) -> float.
+    // Return the new max fraction to clip the ray, 0 to stop,
+    // or maxFraction unchanged to ignore the proxy.
+    template <typename Callback>
+    void raycast(const Vec2& p1, const Vec2& p2, Callback&& callback) const {
+        raycast(p1, p2, 0.f, stack, callback);
+    }
+
+    // The same with every node grown by radius, for sweeping a circle,
+    // and a caller-owned traversal stack so several threads can search
+    // the tree at once; the stack keeps its capacity between calls.
+    template <typename Callback>
+    void raycast(const Vec2& p1, const Vec2& p2, float radius,
+        std::vector<int32_t>& stack, Callback&& callback) const;
+
+private:
+    struct Node {
+        AABB box;
+        int32_t parent = NULL_NODE; // doubles as next free node
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = -1;        // leaf = 0, free = -1
+        uint32_t userData = 0;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+
+    mutable std::vector<int32_t> stack;
+
+    int32_t allocateNode();
+    void freeNode(int32_t node);
+
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    int32_t balance(int32_t node);
+};
+
+template <typename Callback>
+void DynamicTree::query(const AABB& box, Callback&& callback) const
+{
+    if (root == NULL_NODE) return;
+
+    stack.clear();
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        int32_t id = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[id];
+        if (!node.box.overlaps(box)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(id)) return;
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+template <typename Callback>
+void DynamicTree::raycast(const Vec2& p1, const Vec2& p2, float radius,
+    std::vector<int32_t>& stack, Callback&& callback) const
+{
+    if (root == NULL_NODE) return;
+
+    float maxFraction = 1.f;
+    const Vec2 grow = { radius, radius };
+
+    stack.clear();
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        int32_t id = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[id];
+        AABB box = { node.box.min - grow, node.box.max + grow };
+        if (!box.intersectsSegment(p1, p2, maxFraction)) continue;
+
+        if (node.isLeaf()) {
+            float value = callback(id, p1, p2, maxFraction);
+            if (value == 0.f) return;
+            if (value < maxFraction) maxFraction = value;
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
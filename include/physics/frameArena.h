@@ -0,0 +1,144 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for data that only lives for one step.
+//
+// Allocation is a pointer bump; nothing is freed individually. reset()
+// hands the whole arena back at the start of the next step. A step
+// that outgrows the current block chains a bigger one, and the next
+// reset folds them into a single block sized for the largest step so
+// far, so once a scene has settled the arena never touches the heap.
+//
+// Not thread safe: give each thread its own arena.
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialBytes = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Invalidates every allocation made since the last reset.
+    void reset();
+
+    void* allocate(size_t bytes, size_t alignment);
+
+    // Uninitialised storage for count objects.
+    template <typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "frame data must be trivially copyable");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Bumped by every reset; FrameVector uses it to notice stale storage.
+    uint32_t getGeneration() const { return generation; }
+
+    size_t getUsed() const;       // bytes handed out since the last reset
+    size_t getCapacity() const;   // bytes held across all blocks
+    size_t getBlockCount() const { return blocks.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        size_t size = 0;
+    };
+
+    std::vector<Block> blocks;
+    size_t offset = 0;        // into blocks.back()
+    size_t usedBefore = 0;    // filled part of the earlier blocks
+    size_t highWater = 0;
+    uint32_t generation = 0;
+
+    void addBlock(size_t minBytes);
+};
+
+// Append-only array of trivially copyable items kept in a FrameArena.
+//
+// Growing allocates a larger run from the arena and copies; the old run
+// is reclaimed with the rest of the frame. clear() must be called once
+// per frame before the array is used again: it drops storage from an
+// earlier frame, and remembers how big the array got so the first
+// growth of the next frame goes straight to that size.
+template <typename T>
+class FrameVector {
+public:
+    FrameVector() = default;
+    explicit FrameVector(FrameArena& arena) : arena(&arena) {}
+
+    void bind(FrameArena& frameArena) {
+        arena = &frameArena;
+        items = nullptr;
+        count = 0;
+        capacity = 0;
+        generation = frameArena.getGeneration();
+    }
+
+    void clear() {
+        if (generation != arena->getGeneration()) {
+            sizeHint = std::max(sizeHint, capacity);
+            items = nullptr;
+            capacity = 0;
+            generation = arena->getGeneration();
+        }
+        count = 0;
+    }
+
+    void reserve(size_t n) {
+        if (n > capacity) grow(n);
+    }
+
+    void resize(size_t n) {
+        reserve(n);
+        count = n;
+    }
+
+    void push_back(const T& item) {
+        if (count == capacity) grow(count + 1);
+        items[count++] = item;
+    }
+
+    void swap(FrameVector& other) {
+        std::swap(arena, other.arena);
+        std::swap(items, other.items);
+        std::swap(count, other.count);
+        std::swap(capacity, other.capacity);
+        std::swap(sizeHint, other.sizeHint);
+        std::swap(generation, other.generation);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T* data() { return items; }
+    const T* data() const { return items; }
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    T& back() { return items[count - 1]; }
+
+private:
+    FrameArena* arena = nullptr;
+    T* items = nullptr;
+    size_t count = 0;
+    size_t capacity = 0;
+    size_t sizeHint = 0;
+    uint32_t generation = 0;
+
+    void grow(size_t minCapacity) {
+        size_t n = std::max({ minCapacity, capacity * 2, sizeHint, size_t(16) });
+        T* fresh = arena->allocate<T>(n);
+        if (count) std::memcpy(fresh, items, count * sizeof(T));
+        items = fresh;
+        capacity = n;
+    }
+};
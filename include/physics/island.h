@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "physics/bodyStorage.h"
+#include "physics/contact.h"
+#include "physics/frameArena.h"
+
+// Awake dynamic bodies grouped by the contacts connecting them.
+// Static bodies never join islands, so two piles resting on the same
+// floor stay separate. Island k owns
+//   bodies   [bodyStart[k],    bodyStart[k + 1])
+//   contacts [contactStart[k], contactStart[k + 1])
+// Islands are ordered by their lowest body index and keep the original
+// order of bodies and contacts inside them, so the grouping is the same
+// from run to run.
+struct IslandSet {
+    std::vector<uint32_t> bodies;
+    std::vector<uint32_t> bodyStart;
+    std::vector<uint32_t> contacts;
+    std::vector<uint32_t> contactStart;
+
+    size_t count() const { return bodyStart.empty() ? 0 : bodyStart.size() - 1; }
+};
+
+class IslandBuilder {
+public:
+    void build(
+        const BodyStorage& bodies,
+        const FrameVector<Contact>& contacts,
+        IslandSet& islands
+    );
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> islandOf;
+    std::vector<uint32_t> cursor;
+
+    uint32_t findRoot(uint32_t i);
+};
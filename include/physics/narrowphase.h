@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "physics/bodyStorage.h"
+#include "physics/broadphase.h"
+#include "physics/circleBatch.h"
+#include "physics/contact.h"
+#include "physics/frameArena.h"
+
+// Narrowphase dispatch by shape pair.
+//
+// Candidate pairs are ordered so the lower ColliderType comes first and
+// bucketed by shape pair. Each bucket is run by its own instantiation
+// of a templated kernel, picked from a table that is generated at
+// compile time from COLLIDER_TYPE_COUNT, so the per-pair loop has no
+// type branches. A new shape needs a ColliderType value and one
+// ShapePairCollider specialisation per partner; the table follows.
+
+constexpr uint32_t SHAPE_PAIR_COUNT = COLLIDER_TYPE_COUNT * (COLLIDER_TYPE_COUNT + 1) / 2;
+
+// Index of the (a, b) bucket, a <= b.
+constexpr uint32_t shapePairIndex(ColliderType a, ColliderType b)
+{
+    uint32_t i = static_cast<uint32_t>(a);
+    uint32_t j = static_cast<uint32_t>(b);
+    return i * COLLIDER_TYPE_COUNT - i * (i - 1) / 2 + (j - i);
+}
+
+// Per-thread buffers reused from step to step.
+struct NarrowphaseScratch {
+    CircleBatch circles;
+};
+
+// Candidate pairs grouped by shape pair; bucket k owns
+// pairs[start[k], start[k + 1]). Pairs keep their broadphase order
+// inside a bucket. The arrays live in the frame arena passed to build.
+struct PairBuckets {
+    BroadphasePair* pairs = nullptr;
+    uint32_t start[SHAPE_PAIR_COUNT + 1] = {};
+
+    // Pairs with no awake body are dropped.
+    void build(FrameArena& arena, const BodyStorage& bodies,
+        const FrameVector<BroadphasePair>& candidates);
+    uint32_t size() const { return start[SHAPE_PAIR_COUNT]; }
+};
+
+// Appends a contact for every touching pair in buckets.pairs[begin, end).
+// Only reads body state, so disjoint ranges can run concurrently.
+void collideBuckets(
+    const BodyStorage& bodies,
+    float restingSpeed,
+    const PairBuckets& buckets,
+    uint32_t begin, uint32_t end,
+    FrameVector<Contact>& out,
+    NarrowphaseScratch& scratch
+);
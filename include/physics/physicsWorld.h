@@ -1,38 +1,364 @@
 #pragma once
+#include <memory>
 #include <vector>
 #include "physics/rigidBody.h"
 #include "physics/colliders.h"
+#include "physics/bodyStorage.h"
+#include "physics/broadphase.h"
+#include "physics/spatialHashGrid.h"
+#include "physics/dynamicTree.h"
+#include "physics/contact.h"
+#include "physics/collisions.h"
+#include "physics/island.h"
+#include "physics/contactColoring.h"
+#include "physics/contactSolver.h"
+#include "physics/frameArena.h"
+#include "physics/narrowphase.h"
+#include "physics/integrator.h"
+#include "physics/profile.h"
+#include "physics/snapshot.h"
+#include "physics/taskPool.h"
 
-enum class ColliderType {
-    Circle,
-    Box
+struct RaycastHit {
+    BodyHandle body;
+    Vec2 point;
+    Vec2 normal;
+    float fraction = 1.f; // along from -> to
 };
 
-struct PhysicsObject {
-    RigidBody* body;
-    ColliderType type;
-    void* collider;
+// One segment of a batched raycast.
+struct Ray {
+    Vec2 from;
+    Vec2 to;
+};
+
+enum class SolverType {
+    Iterations, // velocity passes, then Baumgarte passes, once per step
+    Substeps    // soft contacts, one pass per substep (TGS style)
+};
+
+enum class PositionCorrection {
+    Baumgarte,   // each pass moves the bodies directly
+    SplitImpulse // passes build pseudo-velocities, integrated once
 };
 
 class PhysicsWorld {
 public:
     Vec2 gravity = {0.f, 9.81f};
 
-    float penetrationPercent = 0.8f; // Baumgarte factor
+    float penetrationPercent = 0.2f; // Baumgarte factor
     float penetrationSlop    = 0.01f;
 
-    void add(RigidBody* body, CircleCollider* collider);
-    void add(RigidBody* body, BoxCollider* collider);
+    // Switch to BruteForce to A/B against the original all-pairs loop.
+    BroadphaseType broadphase = BroadphaseType::SweepAndPrune;
+    float gridCellSize = 64.f; // SpatialHashGrid only, ~2x typical body size
+
+    // Velocity passes over the step's contact array, then position
+    // passes. SplitImpulse solves the position passes as separate
+    // pseudo-velocities that move the bodies once and are then dropped;
+    // penetrationPercent is then the share removed per step rather than
+    // per pass (2 passes at 0.4 hold stacks as well as 4 Baumgarte ones).
+    int solverIterations   = 4;
+    int positionIterations = 4;
+    PositionCorrection positionCorrection = PositionCorrection::Baumgarte;
+
+    // Substeps cuts the step into `substeps` pieces sharing the one
+    // narrowphase: each applies gravity, makes one soft contact pass,
+    // moves the bodies and makes one relax pass. Tall stacks settle for
+    // less work than with more iterations. Contacts act as springs of
+    // contactHertz (capped at a quarter of the substep rate) with
+    // contactDampingRatio. Only penetrationSlop of the settings above
+    // still applies.
+    SolverType solver = SolverType::Iterations;
+    int   substeps = 4;
+    float contactHertz = 60.f;
+    float contactDampingRatio = 10.f;
+
+    // Start each step from the previous step's contact impulses.
+    bool warmStarting = true;
+
+    // Minimum approach speed that triggers restitution.
+    float restitutionThreshold = 0.3f;
+
+    // Threads used by step(), the calling one included. Independent
+    // contact islands are solved in parallel; each island is always
+    // solved in the same order, so results don't depend on this.
+    int threadCount = 1;
+
+    // Islands too big to balance across threads (one large pile) are
+    // split into contact colours solved one after another, each colour
+    // in parallel. Applied regardless of threadCount, so results still
+    // don't depend on it.
+    bool graphColoring = true;
+
+    // Islands whose bodies all stay below both tolerances for
+    // timeToSleep seconds are put to sleep together.
+    bool  allowSleep = true;
+    float sleepLinearTolerance  = 0.05f;  // units/s
+    float sleepAngularTolerance = 0.035f; // rad/s (~2 deg/s)
+    float timeToSleep = 0.5f;             // seconds
+
+    // Continuous collision for circles: bullets, and any circle moving
+    // more than ccdMotionThreshold radii in a step, are swept from where
+    // the step started. At the first new impact the body stops, bounces
+    // off the surface and spends the rest of the step moving again, at
+    // most maxCcdSubsteps times. Everything else only pays the
+    // threshold check.
+    bool  continuousCollision = true;
+    float ccdMotionThreshold  = 1.f;
+    int   maxCcdSubsteps      = 4;
+
+    // ---------- BODIES ----------
+    // The world copies the body and collider into its own storage and
+    // hands back a handle that stays valid until the body is destroyed.
+    // A degenerate polygon creates nothing and returns an invalid handle.
+    BodyHandle createBody(const RigidBody& body, const CircleCollider& collider);
+    BodyHandle createBody(const RigidBody& body, const BoxCollider& collider);
+    BodyHandle createBody(const RigidBody& body, const PolygonCollider& collider);
+
+    // Default materials; a mass of 0 makes the body static.
+    BodyHandle createCircle(const Vec2& position, float radius, float mass);
+    BodyHandle createBox(const Vec2& position, float halfWidth, float halfHeight, float mass);
+
+    // O(1): the last body moves into the hole. Bodies that were resting
+    // on it wake up. Returns false for a stale or null handle.
+    bool destroy(BodyHandle body);
+
+    // False once the body has been destroyed, even after its slot has
+    // been reused. Every other call taking a handle expects a valid one.
+    bool isValid(BodyHandle body) const { return bodies.contains(body); }
 
     void step(float dt);
 
+    // ---------- FIXED TIMESTEP ----------
+    // advance() turns variable frame times into steps of fixedTimeStep.
+    // One call takes at most maxStepsPerFrame steps, and stops early
+    // once stepping has used stepTimeBudget seconds of wall-clock time
+    // (0 for no limit). Time it cannot catch up on is dropped, so an
+    // overloaded frame slows the simulation down instead of making the
+    // next frame slower still.
+    float fixedTimeStep    = 1.f / 60.f;
+    int   maxStepsPerFrame = 4;
+    float stepTimeBudget   = 0.f;
+
+    // Returns the number of steps taken.
+    int advance(float frameTime);
+
+    // How far the time left over by advance() is into the next step,
+    // in [0, 1).
+    float getInterpolationAlpha() const { return accumulator / fixedTimeStep; }
+
+    // ---------- BODY ACCESS ----------
+    size_t getBodyCount() const { return bodies.size(); }
+
+    Vec2  getPosition(BodyHandle body) const { return bodies.position[bodies.indexOf(body)]; }
+    Vec2  getVelocity(BodyHandle body) const { return bodies.velocity[bodies.indexOf(body)]; }
+    float getRotation(BodyHandle body) const { return bodies.rotation[bodies.indexOf(body)]; }
+    float getAngularVelocity(BodyHandle body) const { return bodies.angularVelocity[bodies.indexOf(body)]; }
+
+    // Between the state before and after the last step, by the
+    // interpolation alpha: what render code should draw.
+    Vec2  getInterpolatedPosition(BodyHandle body) const;
+    float getInterpolatedRotation(BodyHandle body) const;
+
+    bool isAwake(BodyHandle body) const { return bodies.awake[bodies.indexOf(body)] != 0; }
+    void wake(BodyHandle body);
+
+    // Setters and applyForce/applyImpulse wake the body. setPosition and
+    // setRotation also wake whatever was asleep against it.
+    void setPosition(BodyHandle body, const Vec2& position);
+    void setVelocity(BodyHandle body, const Vec2& velocity);
+    void setAngularVelocity(BodyHandle body, float angularVelocity);
+    void setRotation(BodyHandle body, float rotation);
+    void setBullet(BodyHandle body, bool bullet);
+
+    void applyForce(BodyHandle body, const Vec2& force);
+    void applyImpulse(
+        BodyHandle body,
+        const Vec2& impulse,
+        const Vec2& contactVector
+    );
+
+    // ---------- STATS ----------
+    // As of the last step; contacts count manifold points.
+    size_t getPairCount() const { return pairs.size(); }
+    size_t getContactCount() const { return contacts.size(); }
+    size_t getAwakeBodyCount() const;
+
+    // Per-phase times and counters of the last steps, recorded while
+    // profiling is set. Always empty when built with PHYSICS_PROFILING=0.
+    bool profiling = false;
+    void setProfileCapacity(size_t frames);
+    const ProfileHistory& getProfileHistory() const;
+
+    // ---------- SNAPSHOTS ----------
+    // Everything step() carries from one step to the next: bodies and
+    // their handles, bounds, the dynamic tree and the warm starting
+    // impulses. Stepping a restored world reproduces the original run
+    // bit for bit, advance() included. Settings (the public fields) are
+    // not saved.
+    void saveSnapshot(WorldSnapshot& snapshot) const;
+
+    // Returns false and leaves the world untouched if the snapshot was
+    // not written by saveSnapshot or is cut short.
+    bool restoreSnapshot(const WorldSnapshot& snapshot);
+
+    // Hash of every body's position, velocity, rotation, angular
+    // velocity and sleep state, in storage order. Two runs given the
+    // same calls in the same order agree on it after every step,
+    // whatever threadCount is, and across machines in
+    // PHYSICS_DETERMINISTIC builds. Costs one pass over those arrays.
+    uint64_t getStateHash() const;
+
+    // ---------- QUERIES ----------
+    // All go through the dynamic tree, which is brought up to date
+    // lazily when another broadphase is driving the simulation.
+    bool raycast(const Vec2& from, const Vec2& to, RaycastHit& hit);
+    void queryAABB(const AABB& box, std::vector<BodyHandle>& results);
+
+    // Bodies whose shape contains the point.
+    void queryPoint(const Vec2& point, std::vector<BodyHandle>& results);
+
+    // First body a circle of the given radius touches when moved from
+    // `from` to `to`. hit.point is where they touch; shapes the circle
+    // already overlaps at the start are ignored.
+    bool castCircle(const Vec2& from, const Vec2& to, float radius, RaycastHit& hit);
+
+    // The closest hit of every ray, into hits[i]; a miss leaves
+    // hits[i].body invalid. Rays are split over threadCount threads,
+    // each with its own traversal stack, so once the stacks have grown
+    // a batch allocates nothing. The world must not be modified while
+    // it runs.
+    void raycastBatch(const Ray* rays, size_t count, RaycastHit* hits);
+
 private:
-    std::vector<PhysicsObject> objects;
+    BodyStorage bodies;
+
+    // Everything built and thrown away within a step lives in the frame
+    // arenas, which are reset when the next step starts; one per thread
+    // for the parallel narrowphase.
+    FrameArena frameArena;
+    std::vector<std::unique_ptr<FrameArena>> threadArenas;
+
+    std::vector<AABB> bounds;
+    FrameVector<BroadphasePair> pairs{ frameArena };
+    SweepAndPrune sweepAndPrune;
+    SpatialHashGrid spatialGrid;
+    DynamicTree tree;
+    bool treeDirty = true;
+    bool boundsStale = true; // a body was added or teleported
+
+    FrameVector<Contact> contacts{ frameArena };
+    PairBuckets pairBuckets;
+
+    // Parallel narrowphase: each thread appends to its own buffer and
+    // records which slice of it every pair range produced.
+    struct PairRangeOutput {
+        uint32_t thread;
+        uint32_t begin;
+        uint32_t end;
+    };
+    std::vector<FrameVector<Contact>> threadContacts;
+    FrameVector<PairRangeOutput> pairRangeOutputs{ frameArena };
+    std::vector<NarrowphaseScratch> threadScratch;
+    ContactCache contactCache;
+    uint32_t stepCount = 0;
+    float accumulator = 0.f; // advance() time not yet stepped
+    float restingSpeed = 0.f;
+
+    // awake bodies as contiguous runs, rebuilt when one wakes or sleeps
+    std::vector<BodyRange> awakeRanges;
+    bool awakeRangesDirty = true;
+
+    IslandBuilder islandBuilder;
+    IslandSet islands;
+    FrameVector<Contact> islandContacts{ frameArena }; // reorder scratch
+    ContactColoring coloring;
+    const Contact* coloredRun = nullptr; // what coloring was last built for
+    size_t coloredCount = 0;
+    ContactSoftness softness;
+
+    // split-impulse position correction, indexed like the bodies
+    FrameVector<Vec2> pseudoVelocity{ frameArena };
+    float pseudoInvDt = 0.f;
+
+    TaskPool taskPool;
+
+    // one tree traversal stack per thread for raycastBatch
+    std::vector<std::vector<int32_t>> queryStacks;
+
+    // restoreSnapshot decodes into these and swaps them in only once the
+    // whole snapshot has read back; the replaced state stays behind as
+    // capacity for the next restore
+    BodyStorage restoredBodies;
+    std::vector<AABB> restoredBounds;
+    DynamicTree restoredTree;
+    ContactCache restoredCache;
+
+#if PHYSICS_PROFILING
+    ProfileHistory profileHistory;
+    StepProfile currentProfile;
+    std::chrono::steady_clock::time_point profileStart;
+
+    void beginProfile();
+    void endProfile();
+#endif
+
+    // circles swept this step, with where they started it
+    struct SweptBody {
+        uint32_t body;
+        Vec2 start;
+    };
+    FrameVector<SweptBody> sweptBodies{ frameArena };
+
+    BodyHandle createPolygon(
+        RigidBody def,
+        const Polygon& polygon,
+        float restitution,
+        float staticFriction,
+        float dynamicFriction
+    );
+
+    enum class SolverPhase {
+        Velocity,
+        Position,
+        SplitImpulse,
+        Substep, // Substeps solver: warm start and soft pass
+        Relax
+    };
+
+    void beginFrame();
+    void updateAwakeRanges();
+    void integrateVelocities(float dt, const Vec2& acceleration);
+    void integratePositions(float dt);
+    void updateBounds();
+    AABB computeBounds(uint32_t i) const;
+    void syncTree();
+    void findPairs();
+    void generateContacts();
+    void generateContactsParallel();
+    void attachManifolds();
+    void buildIslands();
+    void solveIslands(float dt);
+    void solveSubsteps(float dt);
+    void correctPositions(float dt);
+    void solveIslandPhase(SolverPhase phase);
+    void solveIsland(Contact* run, size_t count, SolverPhase phase);
+    void solveColoredIsland(Contact* run, size_t count, SolverPhase phase);
+    bool isColoredIsland(size_t count) const;
+    void storeImpulses();
+
+    void prepareQueries();
+    bool castClosest(const Vec2& from, const Vec2& to, float radius,
+        std::vector<int32_t>& stack, RaycastHit& hit) const;
 
-    void integrate(float dt);
-    void solveCollisions();
+    void findSweptBodies(float dt);
+    void solveContinuous(float dt);
+    bool sweepBody(uint32_t i, const Vec2& from, const Vec2& to,
+        float& fraction, Vec2& normal, uint32_t& other);
+    void resolveImpact(uint32_t i, uint32_t other, const Vec2& normal);
 
-    void resolveCircleVsCircle(PhysicsObject& A, PhysicsObject& B);
-    void resolveCircleVsBox(PhysicsObject& circle, PhysicsObject& box);
-    void resolveAABBvsAABB( PhysicsObject& A, PhysicsObject& B);
+    void wakeBody(uint32_t i);
+    void wakeTouching(uint32_t i);
+    void updateSleep(float dt);
 };
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include "math/Vec2.h"
+#include "math/Transform.h"
+#include "physics/aabb.h"
+
+// Convex polygon in body space, centred on its centroid, wound so that
+// cross(v[i+1] - v[i], v[i+2] - v[i+1]) > 0 (counter-clockwise with y
+// up, clockwise on a y-down screen). Edge normals are computed once
+// when the shape is built so the collision kernels only rotate them.
+struct Polygon {
+    static constexpr int MAX_VERTICES = 8;
+
+    Vec2 vertices[MAX_VERTICES];
+    Vec2 normals[MAX_VERTICES]; // normals[i] is the outward normal of edge i -> i + 1
+    int count = 0;
+
+    // Largest vertex distance from the centroid.
+    float radius = 0.f;
+};
+
+Polygon makeBox(float halfWidth, float halfHeight);
+
+// Takes the convex hull of up to MAX_VERTICES points and re-centres it
+// on its centroid, which is returned through centroid. Returns false
+// for degenerate input (fewer than three non-collinear points).
+bool makePolygon(const Vec2* points, int count, Polygon& polygon, Vec2& centroid);
+
+// Moment of inertia about the centroid for a polygon of the given mass.
+float polygonInertia(const Polygon& polygon, float mass);
+
+AABB computePolygonAABB(const Polygon& polygon, const Transform& xf);
@@ -0,0 +1,108 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Per-step timing and counters.
+//
+// Built with PHYSICS_PROFILING=0 the timers expand to nothing and the
+// world never records a frame; the types stay so callers compile
+// either way. With it on, recording is still off until
+// PhysicsWorld::profiling is set.
+#ifndef PHYSICS_PROFILING
+    #define PHYSICS_PROFILING 1
+#endif
+
+enum class ProfilePhase {
+    Integrate,          // velocities and positions
+    Broadphase,         // bounds and candidate pairs
+    Narrowphase,        // contacts and manifold matching
+    Islands,
+    Solve,              // warm start and velocity iterations
+    PositionCorrection,
+    Continuous,
+    Sleep
+};
+constexpr uint32_t PROFILE_PHASE_COUNT = 8;
+
+const char* getProfilePhaseName(ProfilePhase phase);
+
+struct StepProfile {
+    uint32_t step = 0;
+    uint64_t totalNs = 0;
+    uint64_t phaseNs[PROFILE_PHASE_COUNT] = {};
+
+    uint32_t pairs = 0;        // broadphase candidates
+    uint32_t pairsTested = 0;  // reaching the narrowphase
+    uint32_t contacts = 0;     // manifold points generated
+    uint32_t activeBodies = 0; // awake at the start of the step
+    uint32_t islands = 0;
+    uint32_t sweptBodies = 0;  // continuous collision
+    uint32_t frameBytes = 0;   // frame arena use, all threads
+};
+
+// The last `capacity` frames, overwriting the oldest.
+class ProfileHistory {
+public:
+    explicit ProfileHistory(size_t capacity = 120) { setCapacity(capacity); }
+
+    // Drops every recorded frame.
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const { return frames.size(); }
+
+    void clear() { head = 0; count = 0; }
+    void push(const StepProfile& frame);
+
+    // Oldest first.
+    size_t size() const { return count; }
+    const StepProfile& operator[](size_t i) const;
+
+    // Frames as a JSON array of objects, or CSV with a header row;
+    // times in nanoseconds.
+    void writeJson(std::ostream& out) const;
+    void writeCsv(std::ostream& out) const;
+
+private:
+    std::vector<StepProfile> frames;
+    size_t head = 0;  // next slot to write
+    size_t count = 0;
+};
+
+// Adds the time until the end of the scope to one phase of a frame.
+class ProfileScope {
+public:
+    ProfileScope(StepProfile& frame, ProfilePhase phase, bool enabled)
+        : target(enabled ? &frame.phaseNs[static_cast<uint32_t>(phase)] : nullptr)
+    {
+        if (target) start = Clock::now();
+    }
+
+    ~ProfileScope()
+    {
+        if (target)
+            *target += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t* target;
+    Clock::time_point start;
+};
+
+#if PHYSICS_PROFILING
+    #define PHYSICS_PROFILE_CONCAT_(a, b) a##b
+    #define PHYSICS_PROFILE_CONCAT(a, b) PHYSICS_PROFILE_CONCAT_(a, b)
+    // Times the rest of the enclosing scope into `phase` of the world's
+    // current frame.
+    #define PHYSICS_PROFILE_SCOPE(phase) \
+        ProfileScope PHYSICS_PROFILE_CONCAT(profileScope_, __LINE__)( \
+            currentProfile, phase, profiling)
+#else
+    #define PHYSICS_PROFILE_SCOPE(phase) ((void)0)
+#endif
@@ -1,6 +1,9 @@
 #pragma once
 #include "math/Vec2.h"
 
+// Body description handed to PhysicsWorld::createBody.
+// The world copies it into its own storage; read the simulated
+// state back through the returned BodyHandle.
 struct RigidBody {
     Vec2 position;
     Vec2 velocity;
@@ -15,12 +18,8 @@ struct RigidBody {
     float inertia = 0.f;
     float invInertia = 0.f;
 
-    RigidBody(const Vec2& pos, float m);
+    // Always swept for continuous collision, however slow it moves.
+    bool bullet = false;
 
-    void applyForce(const Vec2& f);
-    void applyImpulse(
-        const Vec2& impulse,
-        const Vec2& contactVector
-    );
-    void integrate(float dt);
+    RigidBody(const Vec2& pos, float m);
 };
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Binary copy of a PhysicsWorld's simulation state, for rollback.
+//
+// The world's state is a set of flat arrays, so a snapshot is those
+// arrays back to back, each one a single memcpy. Keep one snapshot per
+// saved frame and reuse it: once its buffer has grown to the scene's
+// size, saving and restoring never allocate.
+//
+// The layout is only meant to be read back by the same build; it is
+// not a file format.
+class WorldSnapshot {
+public:
+    size_t size() const { return bytes.size(); }
+    bool empty() const { return bytes.empty(); }
+    void clear() { bytes.clear(); }
+
+    const unsigned char* data() const { return bytes.data(); }
+
+private:
+    friend class SnapshotWriter;
+    friend class SnapshotReader;
+
+    std::vector<unsigned char> bytes;
+};
+
+// 64-bit hash of a byte range, for comparing state between runs; not
+// cryptographic.
+uint64_t hashBytes(const void* data, size_t count, uint64_t seed = 0);
+
+// Appends values and arrays to a snapshot, replacing what it held.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(WorldSnapshot& snapshot);
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot data must be trivially copyable");
+        writeBytes(&value, sizeof(T));
+    }
+
+    // Length first, then the elements.
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot data must be trivially copyable");
+        write(static_cast<uint64_t>(values.size()));
+        writeBytes(values.data(), values.size() * sizeof(T));
+    }
+
+private:
+    WorldSnapshot& snapshot;
+
+    void writeBytes(const void* source, size_t count);
+};
+
+// Reads back what a SnapshotWriter wrote, in the same order. A read past
+// the end fails and leaves the target untouched; every later read fails
+// too, so callers only need to check ok() once at the end.
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const WorldSnapshot& snapshot);
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot data must be trivially copyable");
+        return readBytes(&value, sizeof(T));
+    }
+
+    // Resizes values to the stored length; keeps its capacity.
+    template <typename T>
+    bool read(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot data must be trivially copyable");
+        uint64_t count = 0;
+        if (!read(count) || count > remaining() / sizeof(T)) return fail();
+        values.resize(static_cast<size_t>(count));
+        return readBytes(values.data(), values.size() * sizeof(T));
+    }
+
+    bool ok() const { return !failed; }
+    size_t remaining() const { return snapshot.bytes.size() - offset; }
+
+private:
+    const WorldSnapshot& snapshot;
+    size_t offset = 0;
+    bool failed = false;
+
+    bool readBytes(void* target, size_t count);
+    bool fail() { failed = true; return false; }
+};
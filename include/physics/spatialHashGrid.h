@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "physics/aabb.h"
+#include "physics/broadphase.h"
+
+// Uniform grid hashed into a fixed bucket table.
+// Each proxy remembers the cell range it was inserted with and is only
+// moved between buckets when that range changes, so bodies that stay
+// inside their cells cost a handful of compares per step.
+//
+// Proxies covering more than maxCellsPerProxy cells (floors, walls)
+// are kept out of the grid and tested against everything directly.
+class SpatialHashGrid {
+public:
+    int maxCellsPerProxy = 16;
+
+    void findPairs(
+        const std::vector<AABB>& bounds,
+        float cellSize,
+        FrameVector<BroadphasePair>& pairs
+    );
+
+    void clear();
+
+    // Follows the world's swap-and-pop: drops proxy `index` and gives
+    // the last proxy its number.
+    void removeProxy(uint32_t index);
+
+private:
+    struct CellRange {
+        int32_t minX, minY;
+        int32_t maxX, maxY;
+
+        bool operator==(const CellRange& o) const {
+            return minX == o.minX && minY == o.minY &&
+                   maxX == o.maxX && maxY == o.maxY;
+        }
+        bool operator!=(const CellRange& o) const { return !(*this == o); }
+    };
+
+    struct Entry {
+        int32_t cellX;
+        int32_t cellY;
+        uint32_t proxy;
+    };
+
+    struct Proxy {
+        CellRange range;
+        bool inGrid = false;
+        bool large  = false;
+    };
+
+    static constexpr uint32_t BUCKET_COUNT = 4096; // power of two
+
+    float cellSize = 0.f;
+    std::vector<std::vector<Entry>> buckets;
+    std::vector<Proxy> proxies;
+    std::vector<uint32_t> largeProxies;
+
+    CellRange computeRange(const AABB& box) const;
+    static uint32_t hashCell(int32_t x, int32_t y);
+
+    void insert(uint32_t proxy, const CellRange& range);
+    void remove(uint32_t proxy, const CellRange& range);
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads for the data-parallel loops inside a step.
+//
+// parallelFor cuts [0, count) into ranges of `grain` items and deals
+// them out in order to one queue per thread. Each thread works through
+// its own queue front to back and, once that is empty, steals from the
+// back of the others, so a few expensive ranges don't leave the rest of
+// the pool idle. The calling thread takes part as thread 0; with a
+// single thread everything runs inline and no lock is touched.
+class TaskPool {
+public:
+    explicit TaskPool(uint32_t threadCount = 1);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Total threads including the caller. Must not be called from
+    // inside parallelFor.
+    void setThreadCount(uint32_t threadCount);
+    uint32_t getThreadCount() const { return threadCount; }
+
+    // Calls fn(begin, end, threadIndex) for every range and returns once
+    // all of them have run. threadIndex is in [0, getThreadCount()).
+    template <typename F>
+    void parallelFor(uint32_t count, uint32_t grain, F&& fn);
+
+private:
+    using Kernel = void (*)(void* context, uint32_t begin, uint32_t end, uint32_t thread);
+
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // Owner pops at head, thieves at tail. Padded so neighbouring
+    // queues don't share a cache line.
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::vector<Range> ranges;
+        uint32_t head = 0;
+        uint32_t tail = 0;
+    };
+
+    uint32_t threadCount = 1;
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queues;
+
+    // ---------- JOB STATE (guarded by mutex) ----------
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersDone;
+    uint64_t generation = 0;
+    uint32_t busyWorkers = 0;
+    bool quit = false;
+
+    Kernel kernel = nullptr;
+    void* context = nullptr;
+
+    void run(uint32_t count, uint32_t grain, Kernel kernel, void* context);
+    void workerMain(uint32_t thread, uint64_t seenGeneration);
+    bool popRange(uint32_t thread, Range& range);
+    void drain(uint32_t thread);
+    void stopWorkers();
+};
+
+template <typename F>
+void TaskPool::parallelFor(uint32_t count, uint32_t grain, F&& fn)
+{
+    using Fn = std::remove_reference_t<F>;
+
+    Kernel thunk = [](void* ctx, uint32_t begin, uint32_t end, uint32_t thread) {
+        (*static_cast<Fn*>(ctx))(begin, end, thread);
+    };
+    run(count, grain, thunk,
+        const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+}
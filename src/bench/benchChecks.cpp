@@ -0,0 +1,156 @@
+#include "bench/benchChecks.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "physics/circleBatch.h"
+#include "physics/physicsWorld.h"
+
+namespace {
+
+// Same LCG as the bench scenes, so a failure reproduces everywhere.
+struct Random {
+    uint32_t state;
+
+    explicit Random(uint32_t seed) : state(seed * 747796405u + 2891336453u) {}
+
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    // [lo, hi)
+    float range(float lo, float hi) {
+        return lo + (hi - lo) * static_cast<float>(next() & 0xFFFF) / 65536.f;
+    }
+};
+
+// Pairs whose radius sum is the rounded distance between the centres,
+// so distSq and the squared sum land within an ulp of each other and
+// any difference in rounding between kernels flips the result. A few
+// coincident and far-apart pairs are mixed in, and the count is not a
+// multiple of any vector width so every scalar tail runs too.
+void buildBoundaryPairs(CircleBatch& batch)
+{
+    constexpr uint32_t COUNT = 100003;
+    Random random(7);
+
+    batch.clear();
+    for (uint32_t i = 0; i < COUNT; i++) {
+        Vec2 a = { random.range(-1000.f, 1000.f), random.range(-1000.f, 1000.f) };
+        float angle = random.range(0.f, 6.2831853f);
+        float distance = random.range(0.01f, 60.f);
+        Vec2 b = { a.x + distance * std::cos(angle), a.y + distance * std::sin(angle) };
+
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float sum = std::sqrt(dx * dx + dy * dy);
+
+        switch (i % 64) {
+            case 0:  batch.push(a, a, 0.f); break;
+            case 1:  batch.push(a, b, 0.f); break;
+            default: batch.push(a, b, sum); break;
+        }
+    }
+}
+
+bool checkSimd()
+{
+    CircleBatch batch;
+    buildBoundaryPairs(batch);
+
+    const size_t n = batch.size();
+    std::vector<uint32_t> expected(n), hits(n);
+    const size_t expectedCount = circleOverlaps(SimdLevel::Scalar,
+        batch.ax.data(), batch.ay.data(), batch.bx.data(), batch.by.data(),
+        batch.radiusSum.data(), n, expected.data());
+
+    bool passed = true;
+    const SimdLevel supported = detectSimdLevel();
+    for (SimdLevel level : { SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if (level > supported) break;
+
+        size_t count = circleOverlaps(level,
+            batch.ax.data(), batch.ay.data(), batch.bx.data(), batch.by.data(),
+            batch.radiusSum.data(), n, hits.data());
+        bool same = count == expectedCount &&
+            std::memcmp(hits.data(), expected.data(), count * sizeof(uint32_t)) == 0;
+
+        std::printf("simd: %s %zu hits, scalar %zu: %s\n", getSimdLevelName(level),
+            count, expectedCount, same ? "ok" : "MISMATCH");
+        passed = passed && same;
+    }
+    return passed;
+}
+
+// Same units as the bench scenes: pixels, y down.
+bool checkTeleport()
+{
+    constexpr float DT = 1.f / 60.f;
+    constexpr int HEIGHT = 5;
+    constexpr float SIZE = 20.f;
+
+    PhysicsWorld world;
+    world.gravity = { 0.f, 800.f };
+
+    BodyHandle floor = world.createBox({ 0.f, 10.f }, 100.f, 10.f, 0.f);
+    std::vector<BodyHandle> stack;
+    for (int i = 0; i < HEIGHT; i++)
+        stack.push_back(world.createBox({ 0.f, -SIZE / 2 - i * SIZE }, SIZE / 2, SIZE / 2, 1.f));
+
+    for (int k = 0; k < 600 && world.getAwakeBodyCount() > 0; k++)
+        world.step(DT);
+    if (world.getAwakeBodyCount() > 0) {
+        std::printf("teleport: stack never fell asleep: FAIL\n");
+        return false;
+    }
+
+    std::vector<float> restingY;
+    for (BodyHandle box : stack)
+        restingY.push_back(world.getPosition(box).y);
+
+    world.setPosition(floor, { 1000.f, 10.f });
+    for (int k = 0; k < 30; k++)
+        world.step(DT);
+
+    // half a second of free fall is about 100 px
+    float minFall = 1e9f;
+    for (size_t i = 0; i < stack.size(); i++)
+        minFall = std::min(minFall, world.getPosition(stack[i]).y - restingY[i]);
+    bool passed = minFall > 50.f;
+
+    std::printf("teleport: every box fell at least %.1f px: %s\n", minFall, passed ? "ok" : "FAIL");
+    return passed;
+}
+
+} // namespace
+
+const char* getBenchCheckName(BenchCheck check)
+{
+    switch (check) {
+        case BenchCheck::Simd:     return "simd";
+        case BenchCheck::Teleport: return "teleport";
+        default:                   return "unknown";
+    }
+}
+
+bool parseBenchCheck(const char* name, BenchCheck& check)
+{
+    for (BenchCheck c : { BenchCheck::Simd, BenchCheck::Teleport }) {
+        if (std::strcmp(name, getBenchCheckName(c)) == 0) {
+            check = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool runBenchCheck(BenchCheck check)
+{
+    switch (check) {
+        case BenchCheck::Simd:     return checkSimd();
+        case BenchCheck::Teleport: return checkTeleport();
+        default:                   return false;
+    }
+}
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "bench/benchChecks.h"
+#include "bench/benchScenes.h"
+#include "physics/circleBatch.h"
+#include "physics/physicsWorld.h"
+
+// Headless throughput benchmark.
+//
+//   physics_bench [--scene balls|boxes|pile|rain|stacks|all] [--bodies N]
+//                 [--steps N] [--warmup N] [--threads N] [--seed N]
+//                 [--broadphase sap|grid|tree|brute] [--profile json|csv]
+//                 [--solver iterations|substeps]
+//   physics_bench --check simd|teleport|all
+//
+// Every scene is stepped at 1/60 s: first the warmup steps, untimed,
+// then the timed ones. The report is one JSON object on stdout.
+// --profile adds the average time of every step phase to each run and
+// writes the timed steps' frames to profile_<scene>.json or .csv.
+//
+// --check runs correctness checks instead of timing anything and exits
+// non-zero if one fails.
+
+namespace {
+
+constexpr float DT = 1.f / 60.f;
+
+struct BenchOptions {
+    std::vector<BenchScene> scenes;
+    uint32_t bodyCount = 1000;
+    uint32_t steps = 600;
+    uint32_t warmup = 0;
+    uint32_t seed = 1;
+    int threads = 1;
+    BroadphaseType broadphase = BroadphaseType::SweepAndPrune;
+    SolverType solver = SolverType::Iterations;
+    const char* profileFormat = nullptr; // json, csv or null
+    std::vector<BenchCheck> checks;
+};
+
+struct BenchResult {
+    BenchScene scene;
+    size_t bodies = 0;
+    double seconds = 0.0;
+    size_t pairsTotal = 0;
+    size_t contactsTotal = 0;
+    size_t contactsMax = 0;
+    size_t awake = 0;
+
+    bool profiled = false;
+    double phaseNs[PROFILE_PHASE_COUNT] = {};
+};
+
+const char* getBroadphaseName(BroadphaseType type)
+{
+    switch (type) {
+        case BroadphaseType::BruteForce:      return "brute";
+        case BroadphaseType::SweepAndPrune:   return "sap";
+        case BroadphaseType::SpatialHashGrid: return "grid";
+        case BroadphaseType::DynamicTree:     return "tree";
+        default:                              return "unknown";
+    }
+}
+
+bool parseBroadphase(const char* name, BroadphaseType& type)
+{
+    for (BroadphaseType t : { BroadphaseType::BruteForce, BroadphaseType::SweepAndPrune,
+                              BroadphaseType::SpatialHashGrid, BroadphaseType::DynamicTree }) {
+        if (std::strcmp(name, getBroadphaseName(t)) == 0) {
+            type = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* getSolverName(SolverType type)
+{
+    return type == SolverType::Substeps ? "substeps" : "iterations";
+}
+
+bool parseSolver(const char* name, SolverType& type)
+{
+    for (SolverType t : { SolverType::Iterations, SolverType::Substeps }) {
+        if (std::strcmp(name, getSolverName(t)) == 0) {
+            type = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "physics_bench: %s needs a value\n", flag);
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (std::strcmp(flag, "--scene") == 0) {
+            BenchScene scene;
+            if (std::strcmp(value, "all") == 0) {
+                options.scenes.clear();
+            } else if (parseBenchScene(value, scene)) {
+                options.scenes.push_back(scene);
+            } else {
+                std::fprintf(stderr, "physics_bench: unknown scene %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(flag, "--bodies") == 0) {
+            options.bodyCount = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(flag, "--steps") == 0) {
+            options.steps = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(flag, "--warmup") == 0) {
+            options.warmup = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(flag, "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(flag, "--threads") == 0) {
+            options.threads = std::max(1, std::atoi(value));
+        } else if (std::strcmp(flag, "--broadphase") == 0) {
+            if (!parseBroadphase(value, options.broadphase)) {
+                std::fprintf(stderr, "physics_bench: unknown broadphase %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(flag, "--solver") == 0) {
+            if (!parseSolver(value, options.solver)) {
+                std::fprintf(stderr, "physics_bench: unknown solver %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(flag, "--profile") == 0) {
+            if (std::strcmp(value, "json") != 0 && std::strcmp(value, "csv") != 0) {
+                std::fprintf(stderr, "physics_bench: unknown profile format %s\n", value);
+                return false;
+            }
+            options.profileFormat = value;
+        } else if (std::strcmp(flag, "--check") == 0) {
+            BenchCheck check;
+            if (std::strcmp(value, "all") == 0) {
+                options.checks = { BenchCheck::Simd, BenchCheck::Teleport };
+            } else if (parseBenchCheck(value, check)) {
+                options.checks.push_back(check);
+            } else {
+                std::fprintf(stderr, "physics_bench: unknown check %s\n", value);
+                return false;
+            }
+        } else {
+            std::fprintf(stderr, "physics_bench: unknown option %s\n", flag);
+            return false;
+        }
+    }
+
+    if (options.scenes.empty())
+        options.scenes = { BenchScene::Balls, BenchScene::Boxes, BenchScene::Pile,
+                           BenchScene::Rain, BenchScene::Stacks };
+    return true;
+}
+
+// Averages the frames into result and dumps them into the working
+// directory.
+void writeProfile(const ProfileHistory& history, BenchScene scene, const char* format,
+    BenchResult& result)
+{
+    result.profiled = history.size() > 0;
+    for (size_t i = 0; i < history.size(); i++)
+        for (uint32_t p = 0; p < PROFILE_PHASE_COUNT; p++)
+            result.phaseNs[p] += static_cast<double>(history[i].phaseNs[p]) / history.size();
+
+    std::string path = std::string("profile_") + getBenchSceneName(scene) + "." + format;
+    std::ofstream out(path);
+    if (!out) {
+        std::fprintf(stderr, "physics_bench: cannot write %s\n", path.c_str());
+        return;
+    }
+
+    if (std::strcmp(format, "csv") == 0)
+        history.writeCsv(out);
+    else
+        history.writeJson(out);
+}
+
+BenchResult runScene(BenchScene scene, const BenchOptions& options)
+{
+    BenchSceneConfig config;
+    config.scene = scene;
+    config.bodyCount = options.bodyCount;
+    config.seed = options.seed;
+
+    PhysicsWorld world;
+    world.threadCount = options.threads;
+    world.broadphase = options.broadphase;
+    world.solver = options.solver;
+    buildBenchScene(world, config);
+
+    uint32_t step = 0;
+    for (; step < options.warmup; step++) {
+        updateBenchScene(world, config, step);
+        world.step(DT);
+    }
+
+    BenchResult result;
+    result.scene = scene;
+
+    if (options.profileFormat) {
+        world.profiling = true;
+        world.setProfileCapacity(std::max(options.steps, 1u));
+    }
+
+    using Clock = std::chrono::steady_clock;
+    Clock::duration elapsed{};
+
+    for (uint32_t k = 0; k < options.steps; k++, step++) {
+        updateBenchScene(world, config, step);
+
+        auto start = Clock::now();
+        world.step(DT);
+        elapsed += Clock::now() - start;
+
+        result.pairsTotal += world.getPairCount();
+        result.contactsTotal += world.getContactCount();
+        result.contactsMax = std::max(result.contactsMax, world.getContactCount());
+    }
+
+    result.seconds = std::chrono::duration<double>(elapsed).count();
+    result.bodies = world.getBodyCount();
+    result.awake = world.getAwakeBodyCount();
+
+    if (options.profileFormat)
+        writeProfile(world.getProfileHistory(), scene, options.profileFormat, result);
+    return result;
+}
+
+void printResult(const BenchResult& r, const BenchOptions& options, bool last)
+{
+    const double steps = options.steps;
+    const double stepsPerSecond = r.seconds > 0.0 ? steps / r.seconds : 0.0;
+    const double nsPerBodyStep = (steps > 0 && r.bodies > 0)
+        ? r.seconds * 1e9 / (steps * static_cast<double>(r.bodies))
+        : 0.0;
+
+    std::printf("    {\n");
+    std::printf("      \"scene\": \"%s\",\n", getBenchSceneName(r.scene));
+    std::printf("      \"bodies\": %zu,\n", r.bodies);
+    std::printf("      \"awake_bodies\": %zu,\n", r.awake);
+    std::printf("      \"seconds\": %.6f,\n", r.seconds);
+    std::printf("      \"steps_per_sec\": %.2f,\n", stepsPerSecond);
+    std::printf("      \"ns_per_body_step\": %.2f,\n", nsPerBodyStep);
+    std::printf("      \"pairs_avg\": %.1f,\n", steps > 0 ? r.pairsTotal / steps : 0.0);
+    std::printf("      \"contacts_avg\": %.1f,\n", steps > 0 ? r.contactsTotal / steps : 0.0);
+    std::printf("      \"contacts_max\": %zu%s\n", r.contactsMax, r.profiled ? "," : "");
+
+    if (r.profiled) {
+        std::printf("      \"phases_ns_avg\": {");
+        for (uint32_t p = 0; p < PROFILE_PHASE_COUNT; p++)
+            std::printf("%s\"%s\": %.0f", p ? ", " : "",
+                getProfilePhaseName(static_cast<ProfilePhase>(p)), r.phaseNs[p]);
+        std::printf("}\n");
+    }
+    std::printf("    }%s\n", last ? "" : ",");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    if (!options.checks.empty()) {
+        bool passed = true;
+        for (BenchCheck check : options.checks)
+            passed = runBenchCheck(check) && passed;
+        return passed ? 0 : 1;
+    }
+
+    std::printf("{\n");
+    std::printf("  \"steps\": %u,\n", options.steps);
+    std::printf("  \"warmup\": %u,\n", options.warmup);
+    std::printf("  \"body_count\": %u,\n", options.bodyCount);
+    std::printf("  \"threads\": %d,\n", options.threads);
+    std::printf("  \"broadphase\": \"%s\",\n", getBroadphaseName(options.broadphase));
+    std::printf("  \"solver\": \"%s\",\n", getSolverName(options.solver));
+    std::printf("  \"simd\": \"%s\",\n", getSimdLevelName(detectSimdLevel()));
+    std::printf("  \"runs\": [\n");
+
+    for (size_t i = 0; i < options.scenes.size(); i++) {
+        BenchResult result = runScene(options.scenes[i], options);
+        printResult(result, options, i + 1 == options.scenes.size());
+        std::fflush(stdout);
+    }
+
+    std::printf("  ]\n");
+    std::printf("}\n");
+    return 0;
+}
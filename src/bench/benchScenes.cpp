@@ -0,0 +1,198 @@
+#include "bench/benchScenes.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr float WALL = 20.f;        // wall thickness
+constexpr float SPACING = 26.f;     // grid pitch for dropped bodies
+constexpr uint32_t RAIN_INTERVAL = 3; // steps between rain batches
+
+// Small LCG, so scenes don't depend on the standard library's engines.
+struct Random {
+    uint32_t state;
+
+    explicit Random(uint32_t seed) : state(seed * 747796405u + 2891336453u) {}
+
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    // [lo, hi)
+    float range(float lo, float hi) {
+        return lo + (hi - lo) * static_cast<float>(next() & 0xFFFF) / 65536.f;
+    }
+};
+
+struct Arena {
+    float width;
+    float height;
+};
+
+// Room for the bodies laid out on the SPACING grid, at least the demo
+// window.
+Arena arenaFor(uint32_t bodyCount)
+{
+    float side = std::ceil(std::sqrt(static_cast<float>(bodyCount))) * SPACING;
+    return { std::max(800.f, side * 1.5f), std::max(600.f, side * 1.5f) };
+}
+
+void addStaticBox(PhysicsWorld& world, Vec2 center, float width, float height, float rotation = 0.f)
+{
+    RigidBody body(center, 0.f);
+    body.rotation = rotation;
+    world.createBody(body, BoxCollider{ width / 2, height / 2 });
+}
+
+// Floor, ceiling and both walls around [0, width] x [0, height].
+void addContainer(PhysicsWorld& world, const Arena& arena, bool ceiling)
+{
+    const float w = arena.width;
+    const float h = arena.height;
+
+    addStaticBox(world, { w / 2, h + WALL / 2 }, w + 2 * WALL, WALL);
+    addStaticBox(world, { -WALL / 2, h / 2 }, WALL, h);
+    addStaticBox(world, { w + WALL / 2, h / 2 }, WALL, h);
+    if (ceiling)
+        addStaticBox(world, { w / 2, -WALL / 2 }, w + 2 * WALL, WALL);
+}
+
+void addBody(PhysicsWorld& world, Random& random, Vec2 position, Vec2 velocity, bool circle)
+{
+    RigidBody body(position, 1.f);
+    body.velocity = velocity;
+
+    if (circle) {
+        world.createBody(body, CircleCollider{ random.range(5.f, 10.f) });
+    } else {
+        body.rotation = random.range(0.f, 3.14159265f);
+        float halfWidth = random.range(5.f, 10.f);
+        float halfHeight = random.range(5.f, 10.f);
+        world.createBody(body, BoxCollider{ halfWidth, halfHeight });
+    }
+}
+
+// Bodies at grid points inside the arena, row by row from the bottom.
+void addGrid(PhysicsWorld& world, Random& random, const Arena& arena,
+    uint32_t count, float speed, int shapes)
+{
+    const uint32_t columns = std::max(1u, static_cast<uint32_t>((arena.width - SPACING) / SPACING));
+
+    for (uint32_t i = 0; i < count; i++) {
+        Vec2 position = {
+            SPACING * (1 + i % columns),
+            arena.height - SPACING * (1 + i / columns)
+        };
+        Vec2 velocity = { random.range(-speed, speed), random.range(-speed, speed) };
+
+        // 0: circles, 1: boxes, otherwise every other body
+        bool circle = shapes == 0 || (shapes != 1 && (i & 1));
+        addBody(world, random, position, velocity, circle);
+    }
+}
+
+void buildStacks(PhysicsWorld& world, uint32_t bodyCount)
+{
+    constexpr uint32_t HEIGHT = 10;
+    constexpr float SIZE = 20.f;
+    constexpr float PITCH = 40.f;
+
+    const uint32_t columns = (bodyCount + HEIGHT - 1) / HEIGHT;
+    const float width = columns * PITCH + PITCH;
+
+    addStaticBox(world, { width / 2, WALL / 2 }, width, WALL);
+
+    for (uint32_t i = 0; i < bodyCount; i++) {
+        uint32_t column = i / HEIGHT;
+        uint32_t level = i % HEIGHT;
+        RigidBody body({ PITCH * (column + 1), -SIZE / 2 - level * SIZE }, 1.f);
+        world.createBody(body, BoxCollider{ SIZE / 2, SIZE / 2 });
+    }
+}
+
+} // namespace
+
+const char* getBenchSceneName(BenchScene scene)
+{
+    switch (scene) {
+        case BenchScene::Balls:  return "balls";
+        case BenchScene::Boxes:  return "boxes";
+        case BenchScene::Pile:   return "pile";
+        case BenchScene::Rain:   return "rain";
+        case BenchScene::Stacks: return "stacks";
+        default:                 return "unknown";
+    }
+}
+
+bool parseBenchScene(const char* name, BenchScene& scene)
+{
+    for (BenchScene s : { BenchScene::Balls, BenchScene::Boxes, BenchScene::Pile,
+                          BenchScene::Rain, BenchScene::Stacks }) {
+        if (std::strcmp(name, getBenchSceneName(s)) == 0) {
+            scene = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+void buildBenchScene(PhysicsWorld& world, const BenchSceneConfig& config)
+{
+    world.gravity = { 0.f, 800.f };
+
+    Random random(config.seed);
+    const Arena arena = arenaFor(config.bodyCount);
+
+    switch (config.scene) {
+    case BenchScene::Balls:
+        addContainer(world, arena, true);
+        addGrid(world, random, arena, config.bodyCount, 300.f, 0);
+        break;
+    case BenchScene::Boxes:
+        addContainer(world, arena, true);
+        addGrid(world, random, arena, config.bodyCount, 300.f, 1);
+        break;
+    case BenchScene::Pile:
+        addContainer(world, arena, false);
+        addGrid(world, random, arena, config.bodyCount, 0.f, 2);
+        break;
+    case BenchScene::Rain: {
+        addContainer(world, arena, false);
+        // tilted shelves to break up the fall
+        const float w = arena.width;
+        const float h = arena.height;
+        addStaticBox(world, { w * 0.3f, h * 0.45f }, w * 0.3f, WALL, 0.3f);
+        addStaticBox(world, { w * 0.7f, h * 0.65f }, w * 0.3f, WALL, -0.3f);
+        break;
+    }
+    case BenchScene::Stacks:
+        buildStacks(world, config.bodyCount);
+        break;
+    }
+}
+
+// Every RAIN_INTERVAL steps a row of bodies drops in from above the
+// arena, one per lane, until the scene holds bodyCount of them. They
+// start fast enough to clear the spawn row before the next batch.
+void updateBenchScene(PhysicsWorld& world, const BenchSceneConfig& config, uint32_t step)
+{
+    if (config.scene != BenchScene::Rain || step % RAIN_INTERVAL != 0) return;
+
+    const Arena arena = arenaFor(config.bodyCount);
+    const uint32_t lanes = static_cast<uint32_t>((arena.width - 2 * SPACING) / (2 * SPACING));
+    const float lane = (arena.width - 2 * SPACING) / lanes;
+
+    const uint32_t spawned = step / RAIN_INTERVAL * lanes;
+    if (spawned >= config.bodyCount) return;
+
+    Random random(config.seed + step);
+    const uint32_t count = std::min(lanes, config.bodyCount - spawned);
+
+    for (uint32_t k = 0; k < count; k++) {
+        float x = SPACING + lane * (k + 0.5f) + random.range(-0.25f, 0.25f) * lane;
+        Vec2 velocity = { 0.f, random.range(400.f, 600.f) };
+        addBody(world, random, { x, -SPACING }, velocity, (spawned + k) & 1);
+    }
+}
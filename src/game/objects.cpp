@@ -2,7 +2,7 @@
 
 void addBall(
     PhysicsWorld& world,
-    std::deque<Ball>& balls,
+    std::vector<Ball>& balls,
     Vec2 position,
     float radius,
     float mass,
@@ -10,28 +10,28 @@ void addBall(
     Vec2 initalVelocity,
     float restitution
 ) {
+    RigidBody body(position, mass);
+    body.velocity = initalVelocity;
+
+    CircleCollider collider{radius};
+    collider.restitution = restitution;
+
     balls.emplace_back(
         Ball{
-            RigidBody(position, mass),
-            CircleCollider{radius},
+            world.createBody(body, collider),
             sf::CircleShape(radius)
         }
     );
 
     Ball& ball = balls.back();
 
-    ball.body.velocity = initalVelocity;
-    ball.collider.restitution = restitution;
-
     ball.shape.setOrigin({radius, radius});
     ball.shape.setFillColor(color);
-
-    world.add(&ball.body, &ball.collider);
 }
 
 void addRectangle(
     PhysicsWorld& world,
-    std::deque<Rectangle>& rectangles,
+    std::vector<Rectangle>& rectangles,
     Vec2 position,
     float width,
     float height,
@@ -40,21 +40,21 @@ void addRectangle(
     Vec2 initalVelocity,
     float restitution
 ) {
+    RigidBody body(position, mass);
+    body.velocity = initalVelocity;
+
+    BoxCollider collider{width/2, height/2};
+    collider.restitution = restitution;
+
     rectangles.emplace_back(
         Rectangle{
-            RigidBody(position, mass),
-            BoxCollider{width/2, height/2},
+            world.createBody(body, collider),
             sf::RectangleShape({width, height})
         }
     );
 
     Rectangle& rectangle = rectangles.back();
 
-    rectangle.body.velocity = initalVelocity;
-    rectangle.collider.restitution = restitution;
-
     rectangle.shape.setOrigin({width/2, height/2});
     rectangle.shape.setFillColor(color);
-
-    world.add(&rectangle.body, &rectangle.collider);
 }
@@ -0,0 +1,212 @@
+#include "physics/bodyStorage.h"
+
+uint32_t BodyStorage::push(
+    const RigidBody& body,
+    ColliderType shape,
+    const Vec2& extents,
+    float bodyRestitution,
+    float bodyStaticFriction,
+    float bodyDynamicFriction,
+    const Polygon* bodyPolygon
+) {
+    uint32_t index = static_cast<uint32_t>(size());
+
+    position.push_back(body.position);
+    velocity.push_back(body.velocity);
+    force.push_back(body.force);
+    rotation.push_back(body.rotation);
+    angularVelocity.push_back(body.angularVelocity);
+
+    previousPosition.push_back(body.position);
+    previousRotation.push_back(body.rotation);
+
+    mass.push_back(body.mass);
+    invMass.push_back(body.invMass);
+    invInertia.push_back(body.invInertia);
+
+    type.push_back(shape);
+    halfExtents.push_back(extents);
+    restitution.push_back(bodyRestitution);
+    staticFriction.push_back(bodyStaticFriction);
+    dynamicFriction.push_back(bodyDynamicFriction);
+
+    if (bodyPolygon) {
+        polygon.push_back(static_cast<uint32_t>(polygons.size()));
+        polygons.push_back(*bodyPolygon);
+        polygonOwner.push_back(index);
+    } else {
+        polygon.push_back(NO_POLYGON);
+    }
+
+    awake.push_back(body.invMass > 0.f ? 1 : 0);
+    sleepTime.push_back(0.f);
+
+    bullet.push_back(body.bullet ? 1 : 0);
+
+    proxyId.push_back(-1); // DynamicTree::NULL_NODE
+
+    // ---------- HANDLE ----------
+    uint32_t s;
+    if (!freeSlots.empty()) {
+        s = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        s = static_cast<uint32_t>(slotIndex.size());
+        slotIndex.push_back(NO_INDEX);
+        slotGeneration.push_back(0);
+    }
+    slotIndex[s] = index;
+    slot.push_back(s);
+
+    return index;
+}
+
+// Moves element `last` of v into `i` and drops the tail.
+template <typename T>
+static void swapRemove(std::vector<T>& v, uint32_t i, uint32_t last)
+{
+    if (i != last) v[i] = v[last];
+    v.pop_back();
+}
+
+uint32_t BodyStorage::remove(uint32_t index)
+{
+    const uint32_t last = static_cast<uint32_t>(size() - 1);
+
+    if (polygon[index] != NO_POLYGON)
+        removePolygon(polygon[index]);
+
+    // ---------- HANDLE ----------
+    const uint32_t s = slot[index];
+    slotIndex[s] = NO_INDEX;
+    slotGeneration[s]++;
+    retiredSlots.push_back(s);
+    if (index != last) slotIndex[slot[last]] = index;
+
+    // ---------- FIELDS ----------
+    swapRemove(position, index, last);
+    swapRemove(velocity, index, last);
+    swapRemove(force, index, last);
+    swapRemove(rotation, index, last);
+    swapRemove(angularVelocity, index, last);
+
+    swapRemove(previousPosition, index, last);
+    swapRemove(previousRotation, index, last);
+
+    swapRemove(mass, index, last);
+    swapRemove(invMass, index, last);
+    swapRemove(invInertia, index, last);
+
+    swapRemove(type, index, last);
+    swapRemove(halfExtents, index, last);
+    swapRemove(restitution, index, last);
+    swapRemove(staticFriction, index, last);
+    swapRemove(dynamicFriction, index, last);
+    swapRemove(polygon, index, last);
+
+    swapRemove(awake, index, last);
+    swapRemove(sleepTime, index, last);
+    swapRemove(bullet, index, last);
+    swapRemove(proxyId, index, last);
+    swapRemove(slot, index, last);
+
+    if (index != last && polygon[index] != NO_POLYGON)
+        polygonOwner[polygon[index]] = index;
+
+    return last;
+}
+
+// The pool is dense too: the last polygon takes the hole and its owner
+// is pointed at the new place.
+void BodyStorage::removePolygon(uint32_t polygonIndex)
+{
+    const uint32_t last = static_cast<uint32_t>(polygons.size() - 1);
+    if (polygonIndex != last)
+        polygon[polygonOwner[last]] = polygonIndex;
+
+    swapRemove(polygons, polygonIndex, last);
+    swapRemove(polygonOwner, polygonIndex, last);
+}
+
+// Slots are held back until the step has dropped every contact manifold
+// keyed by them, so a new body never inherits a dead one's impulses.
+void BodyStorage::releaseRetiredSlots()
+{
+    freeSlots.insert(freeSlots.end(), retiredSlots.begin(), retiredSlots.end());
+    retiredSlots.clear();
+}
+
+// ---------- SNAPSHOTS ----------
+// Both lists must name the same arrays in the same order.
+void BodyStorage::save(SnapshotWriter& out) const
+{
+    out.write(position);
+    out.write(velocity);
+    out.write(force);
+    out.write(rotation);
+    out.write(angularVelocity);
+
+    out.write(previousPosition);
+    out.write(previousRotation);
+
+    out.write(mass);
+    out.write(invMass);
+    out.write(invInertia);
+
+    out.write(type);
+    out.write(halfExtents);
+    out.write(restitution);
+    out.write(staticFriction);
+    out.write(dynamicFriction);
+    out.write(polygon);
+    out.write(polygons);
+    out.write(polygonOwner);
+
+    out.write(awake);
+    out.write(sleepTime);
+    out.write(bullet);
+    out.write(proxyId);
+
+    out.write(slot);
+    out.write(slotIndex);
+    out.write(slotGeneration);
+    out.write(freeSlots);
+    out.write(retiredSlots);
+}
+
+bool BodyStorage::restore(SnapshotReader& in)
+{
+    in.read(position);
+    in.read(velocity);
+    in.read(force);
+    in.read(rotation);
+    in.read(angularVelocity);
+
+    in.read(previousPosition);
+    in.read(previousRotation);
+
+    in.read(mass);
+    in.read(invMass);
+    in.read(invInertia);
+
+    in.read(type);
+    in.read(halfExtents);
+    in.read(restitution);
+    in.read(staticFriction);
+    in.read(dynamicFriction);
+    in.read(polygon);
+    in.read(polygons);
+    in.read(polygonOwner);
+
+    in.read(awake);
+    in.read(sleepTime);
+    in.read(bullet);
+    in.read(proxyId);
+
+    in.read(slot);
+    in.read(slotIndex);
+    in.read(slotGeneration);
+    in.read(freeSlots);
+    in.read(retiredSlots);
+    return in.ok();
+}
@@ -0,0 +1,50 @@
+#include "physics/broadphase.h"
+#include <algorithm>
+
+void SweepAndPrune::findPairs(
+    const std::vector<AABB>& bounds,
+    FrameVector<BroadphasePair>& pairs
+) {
+    pairs.clear();
+
+    // ---------- TRACK NEW / REMOVED PROXIES ----------
+    if (order.size() > bounds.size()) {
+        order.erase(
+            std::remove_if(order.begin(), order.end(),
+                [&](uint32_t i) { return i >= bounds.size(); }),
+            order.end());
+    }
+    for (uint32_t i = static_cast<uint32_t>(order.size()); i < bounds.size(); i++)
+        order.push_back(i);
+
+    // ---------- INSERTION SORT ON MIN X ----------
+    // Nearly sorted from last step, so this is close to O(n).
+    for (size_t i = 1; i < order.size(); i++) {
+        uint32_t key = order[i];
+        float keyX = bounds[key].min.x;
+
+        size_t j = i;
+        while (j > 0 && bounds[order[j - 1]].min.x > keyX) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = key;
+    }
+
+    // ---------- SWEEP ----------
+    for (size_t i = 0; i < order.size(); i++) {
+        const AABB& A = bounds[order[i]];
+
+        for (size_t j = i + 1; j < order.size(); j++) {
+            const AABB& B = bounds[order[j]];
+            if (B.min.x > A.max.x) break;
+
+            if (B.min.y > A.max.y || B.max.y < A.min.y) continue;
+
+            uint32_t a = order[i];
+            uint32_t b = order[j];
+            if (a > b) std::swap(a, b);
+            pairs.push_back({ a, b });
+        }
+    }
+}
@@ -0,0 +1,219 @@
+#include "physics/circleBatch.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CIRCLE_BATCH_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+
+// GCC and Clang need the ISA enabled per function; MSVC accepts the
+// intrinsics anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+    #define TARGET_ISA(isa) __attribute__((target(isa)))
+#else
+    #define TARGET_ISA(isa)
+#endif
+
+// ---------- SCALAR ----------
+// Same arithmetic as circleVsCircle, operation for operation, so every
+// kernel agrees with it bit for bit. The build compiles this file with
+// FMA contraction off; `physics_bench --check simd` compares the kernels.
+static size_t overlapsScalar(
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t begin, size_t count,
+    uint32_t* hits, size_t hitCount
+) {
+    for (size_t i = begin; i < count; i++) {
+        float dx = bx[i] - ax[i];
+        float dy = by[i] - ay[i];
+        float distSq = dx * dx + dy * dy;
+        if (distSq <= radiusSum[i] * radiusSum[i])
+            hits[hitCount++] = static_cast<uint32_t>(i);
+    }
+    return hitCount;
+}
+
+#ifdef CIRCLE_BATCH_X86
+
+static uint32_t lowestBit(uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return bit;
+#else
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+static size_t popCount(uint32_t mask)
+{
+    size_t n = 0;
+    for (; mask; mask &= mask - 1) n++;
+    return n;
+}
+
+static size_t appendMask(uint32_t mask, size_t base, uint32_t* hits, size_t hitCount)
+{
+    for (; mask; mask &= mask - 1)
+        hits[hitCount++] = static_cast<uint32_t>(base + lowestBit(mask));
+    return hitCount;
+}
+
+// ---------- SSE2 (4 pairs) ----------
+TARGET_ISA("sse2")
+static size_t overlapsSSE2(
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t count, uint32_t* hits
+) {
+    size_t hitCount = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(bx + i), _mm_loadu_ps(ax + i));
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(by + i), _mm_loadu_ps(ay + i));
+        __m128 r  = _mm_loadu_ps(radiusSum + i);
+
+        __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 hit = _mm_cmple_ps(distSq, _mm_mul_ps(r, r));
+
+        hitCount = appendMask(static_cast<uint32_t>(_mm_movemask_ps(hit)), i, hits, hitCount);
+    }
+    return overlapsScalar(ax, ay, bx, by, radiusSum, i, count, hits, hitCount);
+}
+
+// ---------- AVX2 (8 pairs) ----------
+TARGET_ISA("avx2")
+static size_t overlapsAVX2(
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t count, uint32_t* hits
+) {
+    size_t hitCount = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(bx + i), _mm256_loadu_ps(ax + i));
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(by + i), _mm256_loadu_ps(ay + i));
+        __m256 r  = _mm256_loadu_ps(radiusSum + i);
+
+        __m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hit = _mm256_cmp_ps(distSq, _mm256_mul_ps(r, r), _CMP_LE_OQ);
+
+        hitCount = appendMask(static_cast<uint32_t>(_mm256_movemask_ps(hit)), i, hits, hitCount);
+    }
+    _mm256_zeroupper();
+    return overlapsScalar(ax, ay, bx, by, radiusSum, i, count, hits, hitCount);
+}
+
+// ---------- AVX-512 (16 pairs) ----------
+// The compress store writes the hit indices out without a bit loop.
+TARGET_ISA("avx512f")
+static size_t overlapsAVX512(
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t count, uint32_t* hits
+) {
+    const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    size_t hitCount = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(bx + i), _mm512_loadu_ps(ax + i));
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(by + i), _mm512_loadu_ps(ay + i));
+        __m512 r  = _mm512_loadu_ps(radiusSum + i);
+
+        __m512 distSq = _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy));
+        __mmask16 hit = _mm512_cmp_ps_mask(distSq, _mm512_mul_ps(r, r), _CMP_LE_OQ);
+
+        __m512i index = _mm512_add_epi32(lane, _mm512_set1_epi32(static_cast<int>(i)));
+        _mm512_mask_compressstoreu_epi32(hits + hitCount, hit, index);
+        hitCount += popCount(hit);
+    }
+    _mm256_zeroupper();
+    return overlapsScalar(ax, ay, bx, by, radiusSum, i, count, hits, hitCount);
+}
+
+#endif // CIRCLE_BATCH_X86
+
+// ---------- DISPATCH ----------
+SimdLevel detectSimdLevel()
+{
+#if defined(CIRCLE_BATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2"))    return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))    return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+#elif defined(CIRCLE_BATCH_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0;
+        const bool avx512f = (info[1] & (1 << 16)) != 0;
+        if (avx512f && (xcr0 & 0xE6) == 0xE6) return SimdLevel::AVX512;
+        if (avx2 && (xcr0 & 0x6) == 0x6)      return SimdLevel::AVX2;
+    }
+    return sse2 ? SimdLevel::SSE2 : SimdLevel::Scalar;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* getSimdLevelName(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::SSE2:   return "sse2";
+        case SimdLevel::AVX2:   return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default:                return "scalar";
+    }
+}
+
+size_t circleOverlaps(
+    SimdLevel level,
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t count,
+    uint32_t* hits
+) {
+    static const SimdLevel supported = detectSimdLevel();
+    level = std::min(level, supported);
+
+    switch (level) {
+#ifdef CIRCLE_BATCH_X86
+        case SimdLevel::AVX512: return overlapsAVX512(ax, ay, bx, by, radiusSum, count, hits);
+        case SimdLevel::AVX2:   return overlapsAVX2(ax, ay, bx, by, radiusSum, count, hits);
+        case SimdLevel::SSE2:   return overlapsSSE2(ax, ay, bx, by, radiusSum, count, hits);
+#endif
+        default:
+            return overlapsScalar(ax, ay, bx, by, radiusSum, 0, count, hits, 0);
+    }
+}
+
+size_t circleOverlaps(
+    const float* ax, const float* ay,
+    const float* bx, const float* by,
+    const float* radiusSum,
+    size_t count,
+    uint32_t* hits
+) {
+    static const SimdLevel best = detectSimdLevel();
+    return circleOverlaps(best, ax, ay, bx, by, radiusSum, count, hits);
+}
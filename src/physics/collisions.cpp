@@ -1,24 +1,29 @@
+
+
+
 #include "physics/collisions.h"
 #include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
 
 bool circleVsCircle(
-    const Vec2& posA, const CircleCollider& a,
-    const Vec2& posB, const CircleCollider& b
+    const Vec2& posA, float radiusA,
+    const Vec2& posB, float radiusB
 ) {
     Vec2 delta = posB - posA;
     float distSq = delta.dot(delta);
-    float radiusSum = a.radius + b.radius;
+    float radiusSum = radiusA + radiusB;
     return distSq <= radiusSum * radiusSum;
 }
 
 bool circleVsBox(
     const Vec2& circlePos, float radius,
-    const Vec2& boxPos, const BoxCollider& box
+    const Vec2& boxPos, const Vec2& halfExtents
 ) {
-    float left   = boxPos.x - box.halfWidth;
-    float right  = boxPos.x + box.halfWidth;
-    float top    = boxPos.y - box.halfHeight;
-    float bottom = boxPos.y + box.halfHeight;
+    float left   = boxPos.x - halfExtents.x;
+    float right  = boxPos.x + halfExtents.x;
+    float top    = boxPos.y - halfExtents.y;
+    float bottom = boxPos.y + halfExtents.y;
 
     float closestX = clamp(circlePos.x, left, right);
     float closestY = clamp(circlePos.y, top, bottom);
@@ -30,18 +35,18 @@ bool circleVsBox(
 }
 
 bool AABBvsAABB(
-    const Vec2& posA, const BoxCollider& A,
-    const Vec2& posB, const BoxCollider& B
+    const Vec2& posA, const Vec2& halfA,
+    const Vec2& posB, const Vec2& halfB
 ) {
-    float leftA   = posA.x - A.halfWidth;
-    float rightA  = posA.x + A.halfWidth;
-    float topA    = posA.y - A.halfHeight;
-    float bottomA = posA.y + A.halfHeight;
+    float leftA   = posA.x - halfA.x;
+    float rightA  = posA.x + halfA.x;
+    float topA    = posA.y - halfA.y;
+    float bottomA = posA.y + halfA.y;
 
-    float leftB   = posB.x - B.halfWidth;
-    float rightB  = posB.x + B.halfWidth;
-    float topB    = posB.y - B.halfHeight;
-    float bottomB = posB.y + B.halfHeight;
+    float leftB   = posB.x - halfB.x;
+    float rightB  = posB.x + halfB.x;
+    float topB    = posB.y - halfB.y;
+    float bottomB = posB.y + halfB.y;
 
     if (rightA  < leftB)   return false;
     if (leftA   > rightB)  return false;
@@ -50,3 +55,374 @@ bool AABBvsAABB(
 
     return true;
 }
+
+AABB computeAABB(const Vec2& pos, const Vec2& halfExtents) {
+    return { pos - halfExtents, pos + halfExtents };
+}
+
+bool collideCircles(
+    const Vec2& posA, float radiusA,
+    const Vec2& posB, float radiusB,
+    ContactGeometry& contact
+) {
+    Vec2 delta = posB - posA;
+    float dist = delta.magnitude();
+    if (dist <= 0.f) return false;
+
+    float penetration = (radiusA + radiusB) - dist;
+    if (penetration <= 0.f) return false;
+
+    contact.normal = delta / dist;
+    contact.pointCount = 1;
+    contact.points[0] = posA + contact.normal * radiusA;
+    contact.penetration[0] = penetration;
+    contact.id[0] = 0;
+    return true;
+}
+
+bool collideCirclePolygon(
+    const Vec2& circlePos, float radius,
+    const Polygon& polygon, const Transform& xf,
+    ContactGeometry& contact
+) {
+    // work in the polygon's frame
+    Vec2 c = xf.applyInverse(circlePos);
+
+    // ---------- FACE OF LEAST PENETRATION ----------
+    int face = 0;
+    float separation = -INFINITY;
+    for (int i = 0; i < polygon.count; i++) {
+        float s = polygon.normals[i].dot(c - polygon.vertices[i]);
+        if (s > radius) return false;
+        if (s > separation) {
+            separation = s;
+            face = i;
+        }
+    }
+
+    const Vec2& v1 = polygon.vertices[face];
+    const Vec2& v2 = polygon.vertices[(face + 1) % polygon.count];
+
+    Vec2 normal;  // polygon -> circle, local
+    Vec2 point;   // on the polygon surface, local
+    float penetration;
+
+    if (separation < 1e-6f) {
+        // centre inside the polygon
+        normal = polygon.normals[face];
+        point = c - normal * separation;
+        penetration = radius - separation;
+    } else {
+        // ---------- VORONOI REGIONS OF THE FACE ----------
+        float u1 = (c - v1).dot(v2 - v1);
+        float u2 = (c - v2).dot(v1 - v2);
+
+        if (u1 <= 0.f || u2 <= 0.f) {
+            const Vec2& corner = (u1 <= 0.f) ? v1 : v2;
+            Vec2 d = c - corner;
+            float dist = d.magnitude();
+            if (dist > radius || dist < 1e-6f) return false;
+
+            normal = d / dist;
+            point = corner;
+            penetration = radius - dist;
+        } else {
+            normal = polygon.normals[face];
+            point = c - normal * separation;
+            penetration = radius - separation;
+        }
+    }
+
+    if (penetration <= 0.f) return false;
+
+    contact.normal = xf.rotate(normal) * -1.f; // circle -> polygon
+    contact.pointCount = 1;
+    contact.points[0] = xf.apply(point);
+    contact.penetration[0] = penetration;
+    contact.id[0] = 0;
+    return true;
+}
+
+// ---------- POLYGON CLIPPING ----------
+namespace {
+
+struct WorldPolygon {
+    Vec2 vertices[Polygon::MAX_VERTICES];
+    Vec2 normals[Polygon::MAX_VERTICES];
+    int count;
+
+    WorldPolygon(const Polygon& polygon, const Transform& xf) : count(polygon.count) {
+        for (int i = 0; i < count; i++) {
+            vertices[i] = xf.apply(polygon.vertices[i]);
+            normals[i] = xf.rotate(polygon.normals[i]);
+        }
+    }
+};
+
+struct ClipVertex {
+    Vec2 v;
+    uint32_t id;
+};
+
+// Feature id layout: [flip:1][reference edge:4][incident vertex:4].
+// A clipped point keeps the id of the vertex it replaced, so a corner
+// hanging just past the reference edge doesn't lose its warm start
+// every time it crosses the side plane.
+uint32_t featureId(bool flip, int referenceEdge, int incidentVertex)
+{
+    return (uint32_t(flip) << 8) | (uint32_t(referenceEdge) << 4) | uint32_t(incidentVertex);
+}
+
+// Largest separation of b from a along a's edge normals.
+float findMaxSeparation(const WorldPolygon& a, const WorldPolygon& b, int& edge)
+{
+    float best = -INFINITY;
+    edge = 0;
+    for (int i = 0; i < a.count; i++) {
+        float si = INFINITY;
+        for (int j = 0; j < b.count; j++)
+            si = std::min(si, a.normals[i].dot(b.vertices[j] - a.vertices[i]));
+
+        if (si > best) {
+            best = si;
+            edge = i;
+        }
+    }
+    return best;
+}
+
+// Keeps the part of the segment behind the plane dot(n, v) = offset.
+int clipSegment(ClipVertex out[2], const ClipVertex in[2], const Vec2& n, float offset)
+{
+    int count = 0;
+    float d0 = n.dot(in[0].v) - offset;
+    float d1 = n.dot(in[1].v) - offset;
+
+    if (d0 <= 0.f) out[count++] = in[0];
+    if (d1 <= 0.f) out[count++] = in[1];
+
+    if (d0 * d1 < 0.f) {
+        float t = d0 / (d0 - d1);
+        out[count].v = in[0].v + (in[1].v - in[0].v) * t;
+        out[count].id = d0 > 0.f ? in[0].id : in[1].id;
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+bool collidePolygons(
+    const Polygon& polygonA, const Transform& xfA,
+    const Polygon& polygonB, const Transform& xfB,
+    ContactGeometry& contact
+) {
+    WorldPolygon a(polygonA, xfA);
+    WorldPolygon b(polygonB, xfB);
+
+    // ---------- SAT ----------
+    int edgeA;
+    float separationA = findMaxSeparation(a, b, edgeA);
+    if (separationA > 0.f) return false;
+
+    int edgeB;
+    float separationB = findMaxSeparation(b, a, edgeB);
+    if (separationB > 0.f) return false;
+
+    // prefer A as the reference so the choice doesn't flicker between
+    // two nearly equal axes from step to step
+    const float tolerance = 1e-3f * (polygonA.radius + polygonB.radius);
+    bool flip = separationB > separationA + tolerance;
+
+    const WorldPolygon& ref = flip ? b : a;
+    const WorldPolygon& inc = flip ? a : b;
+    int refEdge = flip ? edgeB : edgeA;
+    Vec2 refNormal = ref.normals[refEdge];
+
+    // ---------- INCIDENT EDGE ----------
+    // the edge of the other polygon most anti-parallel to the reference
+    int incEdge = 0;
+    float minDot = INFINITY;
+    for (int i = 0; i < inc.count; i++) {
+        float d = refNormal.dot(inc.normals[i]);
+        if (d < minDot) {
+            minDot = d;
+            incEdge = i;
+        }
+    }
+    int incNext = (incEdge + 1) % inc.count;
+
+    ClipVertex incident[2] = {
+        { inc.vertices[incEdge], featureId(flip, refEdge, incEdge) },
+        { inc.vertices[incNext], featureId(flip, refEdge, incNext) }
+    };
+
+    // ---------- CLIP TO SIDE PLANES ----------
+    Vec2 v11 = ref.vertices[refEdge];
+    Vec2 v12 = ref.vertices[(refEdge + 1) % ref.count];
+    Vec2 tangent = (v12 - v11).normalized();
+
+    ClipVertex clip1[2];
+    if (clipSegment(clip1, incident, tangent * -1.f, -tangent.dot(v11)) < 2) return false;
+
+    ClipVertex clip2[2];
+    if (clipSegment(clip2, clip1, tangent, tangent.dot(v12)) < 2) return false;
+
+    // ---------- KEEP POINTS BEHIND THE REFERENCE FACE ----------
+    float frontOffset = refNormal.dot(v11);
+
+    contact.pointCount = 0;
+    for (const ClipVertex& cv : clip2) {
+        float separation = refNormal.dot(cv.v) - frontOffset;
+        if (separation > 0.f) continue;
+
+        int k = contact.pointCount++;
+        // halfway between the incident vertex and the reference face
+        contact.points[k] = cv.v - refNormal * (0.5f * separation);
+        contact.penetration[k] = -separation;
+        contact.id[k] = cv.id;
+    }
+    if (contact.pointCount == 0) return false;
+
+    contact.normal = flip ? refNormal * -1.f : refNormal; // a -> b
+    return true;
+}
+
+bool raycastCircle(
+    const Vec2& p1, const Vec2& p2, float maxFraction,
+    const Vec2& center, float radius,
+    float& fraction, Vec2& normal
+) {
+    Vec2 s = p1 - center;
+    float c = s.dot(s) - radius * radius;
+    if (c < 0.f) return false; // starts inside
+
+    Vec2 d = p2 - p1;
+    float b = s.dot(d);
+    float dd = d.dot(d);
+    float disc = b * b - dd * c;
+    if (disc < 0.f || dd < 1e-12f) return false;
+
+    float t = -(b + std::sqrt(disc)) / dd;
+    if (t < 0.f || t > maxFraction) return false;
+
+    fraction = t;
+    normal = (s + d * t).normalized();
+    return true;
+}
+
+bool raycastPolygon(
+    const Vec2& p1, const Vec2& p2, float maxFraction,
+    const Polygon& polygon, const Transform& xf,
+    float& fraction, Vec2& normal
+) {
+    Vec2 o = xf.applyInverse(p1);
+    Vec2 d = xf.invRotate(p2 - p1);
+
+    // clip the segment against every edge plane
+    float lower = 0.f;
+    float upper = maxFraction;
+    int face = -1;
+
+    for (int i = 0; i < polygon.count; i++) {
+        float numerator = polygon.normals[i].dot(polygon.vertices[i] - o);
+        float denominator = polygon.normals[i].dot(d);
+
+        if (denominator == 0.f) {
+            if (numerator < 0.f) return false; // parallel and outside
+            continue;
+        }
+
+        if (denominator < 0.f && numerator < lower * denominator) {
+            lower = numerator / denominator; // entering this plane
+            face = i;
+        } else if (denominator > 0.f && numerator < upper * denominator) {
+            upper = numerator / denominator; // leaving
+        }
+
+        if (upper < lower) return false;
+    }
+
+    if (face < 0) return false; // starts inside
+
+    fraction = lower;
+    normal = xf.rotate(polygon.normals[face]);
+    return true;
+}
+
+bool testPointPolygon(const Vec2& point, const Polygon& polygon, const Transform& xf)
+{
+    Vec2 p = xf.applyInverse(point);
+    for (int i = 0; i < polygon.count; i++)
+        if (polygon.normals[i].dot(p - polygon.vertices[i]) > 0.f)
+            return false;
+    return true;
+}
+
+// The swept circle's centre is a ray against the polygon rounded by
+// the radius: every edge pushed out along its normal, plus a circle
+// around every vertex.
+bool sweepCirclePolygon(
+    const Vec2& p1, const Vec2& p2, float radius, float maxFraction,
+    const Polygon& polygon, const Transform& xf,
+    float& fraction, Vec2& normal
+) {
+    Vec2 o = xf.applyInverse(p1);
+    Vec2 d = xf.invRotate(p2 - p1);
+    Vec2 e = o + d;
+
+    // starts inside the rounded polygon: no hit
+    float separation = -INFINITY;
+    for (int i = 0; i < polygon.count; i++)
+        separation = std::max(separation, polygon.normals[i].dot(o - polygon.vertices[i]));
+    if (separation <= radius) {
+        if (separation <= 0.f) return false;
+        for (int i = 0; i < polygon.count; i++) {
+            Vec2 v1 = polygon.vertices[i];
+            Vec2 edge = polygon.vertices[i + 1 < polygon.count ? i + 1 : 0] - v1;
+            float t = std::clamp((o - v1).dot(edge) / edge.dot(edge), 0.f, 1.f);
+            if ((o - (v1 + edge * t)).magnitudeSquared() <= radius * radius)
+                return false;
+        }
+    }
+
+    float best = maxFraction;
+    Vec2 bestNormal;
+    bool hit = false;
+
+    for (int i = 0; i < polygon.count; i++) {
+        const Vec2& n = polygon.normals[i];
+        const Vec2& v1 = polygon.vertices[i];
+        const Vec2& v2 = polygon.vertices[i + 1 < polygon.count ? i + 1 : 0];
+
+        // the pushed-out edge, entered from the front
+        float denominator = n.dot(d);
+        if (denominator < 0.f) {
+            float t = (radius - n.dot(o - v1)) / denominator;
+            if (t >= 0.f && t <= best) {
+                Vec2 p = o + d * t;
+                Vec2 edge = v2 - v1;
+                float s = (p - v1).dot(edge);
+                if (s >= 0.f && s <= edge.dot(edge)) {
+                    best = t;
+                    bestNormal = n;
+                    hit = true;
+                }
+            }
+        }
+
+        float t;
+        Vec2 vertexNormal;
+        if (raycastCircle(o, e, best, v1, radius, t, vertexNormal)) {
+            best = t;
+            bestNormal = vertexNormal;
+            hit = true;
+        }
+    }
+
+    if (!hit) return false;
+
+    fraction = best;
+    normal = xf.rotate(bestNormal);
+    return true;
+}
@@ -0,0 +1,114 @@
+#include "physics/contact.h"
+#include <algorithm>
+
+static constexpr size_t MIN_SLOTS = 64;
+
+size_t ContactCache::home(uint64_t k) const
+{
+    // 64-bit mix so neighbouring body pairs spread over the table
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    return static_cast<size_t>(k) & (slots.size() - 1);
+}
+
+size_t ContactCache::findSlot(uint64_t k) const
+{
+    const size_t mask = slots.size() - 1;
+    size_t i = home(k);
+    while (slots[i].manifold != EMPTY && slots[i].key != k)
+        i = (i + 1) & mask;
+    return i;
+}
+
+uint32_t ContactCache::find(uint32_t a, uint32_t b)
+{
+    if ((manifolds.size() + 1) * 2 > slots.size())
+        rehash(std::max(MIN_SLOTS, slots.size() * 2));
+
+    const uint64_t k = key(a, b);
+    Slot& slot = slots[findSlot(k)];
+
+    if (slot.manifold == EMPTY) {
+        slot.key = k;
+        slot.manifold = static_cast<uint32_t>(manifolds.size());
+
+        ContactManifold m;
+        m.a = a;
+        m.b = b;
+        manifolds.push_back(m);
+    }
+    return slot.manifold;
+}
+
+void ContactCache::removeStale(uint32_t stamp)
+{
+    size_t i = 0;
+    while (i < manifolds.size()) {
+        if (manifolds[i].stamp == stamp) {
+            i++;
+            continue;
+        }
+
+        // swap-and-pop, re-pointing the moved manifold's lookup entry
+        eraseSlot(findSlot(key(manifolds[i].a, manifolds[i].b)));
+        if (i + 1 != manifolds.size()) {
+            manifolds[i] = manifolds.back();
+            slots[findSlot(key(manifolds[i].a, manifolds[i].b))].manifold = static_cast<uint32_t>(i);
+        }
+        manifolds.pop_back();
+    }
+}
+
+void ContactCache::clear()
+{
+    manifolds.clear();
+    for (Slot& slot : slots)
+        slot = Slot{};
+}
+
+void ContactCache::save(SnapshotWriter& out) const
+{
+    out.write(manifolds);
+    out.write(slots);
+}
+
+bool ContactCache::restore(SnapshotReader& in)
+{
+    in.read(manifolds);
+    in.read(slots);
+    return in.ok();
+}
+
+// Backward-shift deletion: later entries of the probe run move up into
+// the hole when their home slot allows it, so the table needs no
+// tombstones and lookups never slow down with churn.
+void ContactCache::eraseSlot(size_t i)
+{
+    const size_t mask = slots.size() - 1;
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (slots[j].manifold == EMPTY) break;
+
+        // entry j can fill the hole at i unless its home lies in (i, j]
+        size_t h = home(slots[j].key);
+        bool homeBetween = (i <= j) ? (i < h && h <= j) : (i < h || h <= j);
+        if (homeBetween) continue;
+
+        slots[i] = slots[j];
+        i = j;
+    }
+    slots[i] = Slot{};
+}
+
+void ContactCache::rehash(size_t slotCount)
+{
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(slotCount, Slot{});
+
+    for (const Slot& slot : old)
+        if (slot.manifold != EMPTY)
+            slots[findSlot(slot.key)] = slot;
+}
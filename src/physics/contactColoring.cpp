@@ -0,0 +1,82 @@
+#include "physics/contactColoring.h"
+#include <algorithm>
+#include <cassert>
+
+static uint32_t lowestClearBit(uint64_t used)
+{
+    uint32_t c = 0;
+    while (c < ContactColoring::MAX_COLORS && (used & (uint64_t(1) << c)))
+        c++;
+    return c;
+}
+
+void ContactColoring::build(const BodyStorage& bodies, Contact* run, size_t count)
+{
+    if (bodyColors.size() < bodies.size())
+        bodyColors.resize(bodies.size(), 0);
+
+    // ---------- GREEDY COLOURING ----------
+    const uint32_t overflow = MAX_COLORS;
+    uint32_t usedColors = 0;
+    hasOverflow = false;
+
+    contactColor.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const Contact& c = run[i];
+
+        // a manifold's second point shares both bodies with the first:
+        // it takes the same colour, so the two stay adjacent for the
+        // block solve
+        if (isSecondPoint(run, i)) {
+            contactColor[i] = contactColor[i - 1];
+            continue;
+        }
+        bool dynamicA = c.invMassA > 0.f;
+        bool dynamicB = c.invMassB > 0.f;
+
+        uint64_t used = 0;
+        if (dynamicA) used |= bodyColors[c.a];
+        if (dynamicB) used |= bodyColors[c.b];
+
+        uint32_t color = lowestClearBit(used);
+        if (color == overflow) {
+            hasOverflow = true;
+        } else {
+            uint64_t bit = uint64_t(1) << color;
+            if (dynamicA) bodyColors[c.a] |= bit;
+            if (dynamicB) bodyColors[c.b] |= bit;
+            usedColors = std::max(usedColors, color + 1);
+        }
+        contactColor[i] = static_cast<uint8_t>(color);
+    }
+
+    // masks are only touched through this island's contacts
+    for (size_t i = 0; i < count; i++) {
+        bodyColors[run[i].a] = 0;
+        bodyColors[run[i].b] = 0;
+    }
+
+    // ---------- COUNTING SORT BY COLOUR ----------
+    // the overflow group, if any, goes last
+    const uint32_t groups = usedColors + (hasOverflow ? 1 : 0);
+    auto group = [&](size_t i) {
+        return contactColor[i] == overflow ? usedColors : contactColor[i];
+    };
+
+    colorStart.assign(groups + 1, 0);
+    for (size_t i = 0; i < count; i++)
+        colorStart[group(i) + 1]++;
+    for (uint32_t g = 0; g < groups; g++)
+        colorStart[g + 1] += colorStart[g];
+
+    scratch.resize(count);
+    cursor.assign(colorStart.begin(), colorStart.end() - 1);
+    for (size_t i = 0; i < count; i++)
+        scratch[cursor[group(i)]++] = run[i];
+
+    std::copy(scratch.begin(), scratch.end(), run);
+
+    // the block solve only sees a manifold's points when they are adjacent
+    for (size_t i = 0; i < count; i++)
+        assert(run[i].point == 0 || isSecondPoint(run, i));
+}
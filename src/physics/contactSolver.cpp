@@ -0,0 +1,322 @@
+#include "physics/contactSolver.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
+
+// Static bodies are never written: they are shared between islands
+// that may be solved on different threads.
+static void applyImpulse(BodyStorage& bodies, const Contact& c, const Vec2& impulse)
+{
+    if (c.invMassA > 0.f) {
+        bodies.velocity[c.a] -= impulse * c.invMassA;
+        bodies.angularVelocity[c.a] -= cross(c.rA, impulse) * c.invInertiaA;
+    }
+    if (c.invMassB > 0.f) {
+        bodies.velocity[c.b] += impulse * c.invMassB;
+        bodies.angularVelocity[c.b] += cross(c.rB, impulse) * c.invInertiaB;
+    }
+}
+
+static Vec2 relativeVelocity(const BodyStorage& bodies, const Contact& c)
+{
+    Vec2 velA = bodies.velocity[c.a] + perp(c.rA) * bodies.angularVelocity[c.a];
+    Vec2 velB = bodies.velocity[c.b] + perp(c.rB) * bodies.angularVelocity[c.b];
+    return velB - velA;
+}
+
+void warmStartContacts(BodyStorage& bodies, const Contact* contacts, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        const Contact& c = contacts[i];
+
+        Vec2 tangent = perp(c.normal);
+        Vec2 impulse = c.normal * c.normalImpulse +
+                       tangent  * c.tangentImpulse;
+        applyImpulse(bodies, c, impulse);
+    }
+}
+
+static void solveNormal(BodyStorage& bodies, Contact& c)
+{
+    float vn = relativeVelocity(bodies, c).dot(c.normal);
+
+    float j = -(vn - c.velocityBias) * c.normalMass;
+    float oldNormal = c.normalImpulse;
+    c.normalImpulse = std::max(oldNormal + j, 0.f);
+    j = c.normalImpulse - oldNormal;
+
+    applyImpulse(bodies, c, c.normal * j);
+}
+
+static void solveFriction(BodyStorage& bodies, Contact& c)
+{
+    Vec2 tangent = perp(c.normal);
+    float vt = relativeVelocity(bodies, c).dot(tangent);
+
+    // static friction holds up to muS * N, past that it slips at muD * N
+    float jt = -vt * c.tangentMass;
+    float oldTangent = c.tangentImpulse;
+    float newTangent = oldTangent + jt;
+    if (std::abs(newTangent) > c.staticFriction * c.normalImpulse)
+        newTangent = std::copysign(c.dynamicFriction * c.normalImpulse, newTangent);
+    c.tangentImpulse = newTangent;
+    jt = newTangent - oldTangent;
+
+    applyImpulse(bodies, c, tangent * jt);
+}
+
+// Both points of a two-point manifold at once, as a 2x2 LCP (same
+// case enumeration as Box2D's block solver). Solving them one after
+// the other leaves a small torque behind each pass, which is enough to
+// make a column of boxes sway. Returns false when the pair is too
+// close to singular (points nearly on top of each other).
+//
+// A soft contact's new impulse is massScale times the rigid one, which
+// is the same LCP with K / massScale on the solving side; massScale 1
+// is the rigid solve.
+static bool solveNormalBlock(
+    BodyStorage& bodies, Contact& c1, Contact& c2,
+    float bias1, float bias2, float massScale
+) {
+    const Vec2& n = c1.normal;
+
+    float rn1A = cross(c1.rA, n), rn1B = cross(c1.rB, n);
+    float rn2A = cross(c2.rA, n), rn2B = cross(c2.rB, n);
+
+    float k11 = 1.f / c1.normalMass;
+    float k22 = 1.f / c2.normalMass;
+    float k12 = c1.invMassA + c1.invMassB +
+        c1.invInertiaA * rn1A * rn2A + c1.invInertiaB * rn1B * rn2B;
+
+    // b = vn - bias - K a, with a the accumulated impulses
+    float a1 = c1.normalImpulse;
+    float a2 = c2.normalImpulse;
+    float b1 = relativeVelocity(bodies, c1).dot(n) - bias1 - (k11 * a1 + k12 * a2);
+    float b2 = relativeVelocity(bodies, c2).dot(n) - bias2 - (k12 * a1 + k22 * a2);
+
+    k11 /= massScale;
+    k22 /= massScale;
+    k12 /= massScale;
+
+    float det = k11 * k22 - k12 * k12;
+    if (k11 * k11 >= 1000.f * det) return false;
+
+    float x1, x2;
+    for (;;) {
+        // both points pushing: K x = -b
+        x1 = -(k22 * b1 - k12 * b2) / det;
+        x2 = -(k11 * b2 - k12 * b1) / det;
+        if (x1 >= 0.f && x2 >= 0.f) break;
+
+        // only the first
+        x1 = -b1 / k11;
+        x2 = 0.f;
+        if (x1 >= 0.f && k12 * x1 + b2 >= 0.f) break;
+
+        // only the second
+        x1 = 0.f;
+        x2 = -b2 / k22;
+        if (x2 >= 0.f && k12 * x2 + b1 >= 0.f) break;
+
+        // neither
+        x1 = 0.f;
+        x2 = 0.f;
+        if (b1 >= 0.f && b2 >= 0.f) break;
+
+        return true; // no consistent case, keep the old impulses
+    }
+
+    Vec2 p1 = n * (x1 - a1);
+    Vec2 p2 = n * (x2 - a2);
+    if (c1.invMassA > 0.f) {
+        bodies.velocity[c1.a] -= (p1 + p2) * c1.invMassA;
+        bodies.angularVelocity[c1.a] -= (cross(c1.rA, p1) + cross(c2.rA, p2)) * c1.invInertiaA;
+    }
+    if (c1.invMassB > 0.f) {
+        bodies.velocity[c1.b] += (p1 + p2) * c1.invMassB;
+        bodies.angularVelocity[c1.b] += (cross(c1.rB, p1) + cross(c2.rB, p2)) * c1.invInertiaB;
+    }
+    c1.normalImpulse = x1;
+    c2.normalImpulse = x2;
+    return true;
+}
+
+void solveVelocityConstraints(BodyStorage& bodies, Contact* contacts, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        Contact& c = contacts[i];
+
+        // the second point of the same manifold directly follows
+        bool pair = i + 1 < count &&
+            contacts[i + 1].point == 1 && contacts[i + 1].manifold == c.manifold;
+
+        if (pair) {
+            Contact& c2 = contacts[i + 1];
+            if (!solveNormalBlock(bodies, c, c2, c.velocityBias, c2.velocityBias, 1.f)) {
+                solveNormal(bodies, c);
+                solveNormal(bodies, c2);
+            }
+            solveFriction(bodies, c);
+            solveFriction(bodies, c2);
+            i++;
+            continue;
+        }
+
+        solveNormal(bodies, c);
+        solveFriction(bodies, c);
+    }
+}
+
+// ---------- SOFT CONTACT ----------
+ContactSoftness makeContactSoftness(float hertz, float dampingRatio, float h)
+{
+    const float omega = 2.f * 3.14159265f * hertz;
+    const float a1 = 2.f * dampingRatio + h * omega;
+    const float a2 = h * omega * a1;
+    const float a3 = 1.f / (1.f + a2);
+
+    ContactSoftness softness;
+    softness.biasRate = omega / a1;
+    softness.massScale = a2 * a3;
+    softness.impulseScale = a3;
+    softness.invH = 1.f / h;
+    return softness;
+}
+
+// The anchors coincided at the narrowphase, which saw the bodies as
+// they started the step; turned with the bodies since (to first order),
+// their separation is how far the contact has opened. Leaving the turn
+// out would give a tilting box no push back.
+static float currentPenetration(const BodyStorage& bodies, const Contact& c)
+{
+    float turnA = bodies.rotation[c.a] - bodies.previousRotation[c.a];
+    float turnB = bodies.rotation[c.b] - bodies.previousRotation[c.b];
+    Vec2 anchorA = bodies.position[c.a] + c.rA + perp(c.rA) * turnA;
+    Vec2 anchorB = bodies.position[c.b] + c.rB + perp(c.rB) * turnB;
+    return c.penetration - (anchorB - anchorA).dot(c.normal);
+}
+
+// Bias velocity and mass scale of one soft contact point.
+struct SoftTarget {
+    float bias;
+    float massScale;
+    float impulseScale;
+};
+
+static SoftTarget getSoftTarget(
+    const BodyStorage& bodies, const Contact& c,
+    const ContactSoftness& softness, float slop, bool useBias
+) {
+    float penetration = currentPenetration(bodies, c);
+
+    SoftTarget target{ c.velocityBias, 1.f, 0.f };
+    if (penetration < 0.f) {
+        // still apart: only stop it closing the gap within the substep
+        target.bias = penetration * softness.invH;
+    } else if (useBias) {
+        target.bias = std::max(target.bias, softness.biasRate * std::max(penetration - slop, 0.f));
+        target.massScale = softness.massScale;
+        target.impulseScale = softness.impulseScale;
+    }
+    return target;
+}
+
+static void solveSoftNormal(BodyStorage& bodies, Contact& c, const SoftTarget& target)
+{
+    float vn = relativeVelocity(bodies, c).dot(c.normal);
+    float j = -c.normalMass * target.massScale * (vn - target.bias) - target.impulseScale * c.normalImpulse;
+    float oldNormal = c.normalImpulse;
+    c.normalImpulse = std::max(oldNormal + j, 0.f);
+    j = c.normalImpulse - oldNormal;
+
+    applyImpulse(bodies, c, c.normal * j);
+}
+
+void solveSoftVelocityConstraints(
+    BodyStorage& bodies,
+    Contact* contacts, size_t count,
+    const ContactSoftness& softness,
+    float slop, bool useBias
+) {
+    for (size_t i = 0; i < count; i++) {
+        Contact& c = contacts[i];
+        SoftTarget t1 = getSoftTarget(bodies, c, softness, slop, useBias);
+
+        bool pair = i + 1 < count &&
+            contacts[i + 1].point == 1 && contacts[i + 1].manifold == c.manifold;
+
+        if (pair) {
+            // the block solve takes one mass scale for both points: the
+            // softer one, so a point that is still apart does not make
+            // its penetrating partner rigid
+            Contact& c2 = contacts[i + 1];
+            SoftTarget t2 = getSoftTarget(bodies, c2, softness, slop, useBias);
+            float massScale = std::min(t1.massScale, t2.massScale);
+
+            if (!solveNormalBlock(bodies, c, c2, t1.bias, t2.bias, massScale)) {
+                solveSoftNormal(bodies, c, t1);
+                solveSoftNormal(bodies, c2, t2);
+            }
+            solveFriction(bodies, c);
+            solveFriction(bodies, c2);
+            i++;
+            continue;
+        }
+
+        solveSoftNormal(bodies, c, t1);
+        solveFriction(bodies, c);
+    }
+}
+
+// ---------- SPLIT IMPULSE ----------
+// Positions do not move until the caller integrates, so each contact's
+// target stays put and the accumulated pseudo impulse converges on it
+// whatever order the contacts come in. Linear only, like the Baumgarte
+// pass: turning bodies apart as well left piles restless.
+void solvePseudoVelocityConstraints(
+    const BodyStorage& bodies, Vec2* pseudoVelocity,
+    Contact* contacts, size_t count,
+    float percent, float slop, float invDt
+) {
+    for (size_t i = 0; i < count; i++) {
+        Contact& c = contacts[i];
+
+        float penetration = currentPenetration(bodies, c);
+        float bias = percent * std::max(penetration - slop, 0.f) * invDt;
+        float vn = (pseudoVelocity[c.b] - pseudoVelocity[c.a]).dot(c.normal);
+
+        float j = -(vn - bias) / (c.invMassA + c.invMassB);
+        float oldImpulse = c.pseudoImpulse;
+        c.pseudoImpulse = std::max(oldImpulse + j, 0.f);
+        Vec2 impulse = c.normal * (c.pseudoImpulse - oldImpulse);
+
+        if (c.invMassA > 0.f) pseudoVelocity[c.a] -= impulse * c.invMassA;
+        if (c.invMassB > 0.f) pseudoVelocity[c.b] += impulse * c.invMassB;
+    }
+}
+
+void solvePositionConstraints(
+    BodyStorage& bodies,
+    const Contact* contacts, size_t count,
+    float percent, float slop
+) {
+    for (size_t i = 0; i < count; i++) {
+        const Contact& c = contacts[i];
+
+        Vec2& posA = bodies.position[c.a];
+        Vec2& posB = bodies.position[c.b];
+
+        // the anchors coincided at the narrowphase, so their separation
+        // along the normal is how much the penetration has changed since
+        float moved = ((posB + c.rB) - (posA + c.rA)).dot(c.normal);
+        float penetration = c.penetration - moved;
+
+        float correctionMag =
+            std::max(penetration - slop, 0.f) /
+            (c.invMassA + c.invMassB) * percent;
+
+        Vec2 correction = c.normal * correctionMag;
+        if (c.invMassA > 0.f) posA -= correction * c.invMassA;
+        if (c.invMassB > 0.f) posB += correction * c.invMassB;
+    }
+}
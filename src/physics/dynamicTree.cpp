@@ -0,0 +1,300 @@
+#include "physics/dynamicTree.h"
+#include <algorithm>
+
+int32_t DynamicTree::allocateNode()
+{
+    if (freeList == NULL_NODE) {
+        nodes.emplace_back();
+        freeList = static_cast<int32_t>(nodes.size()) - 1;
+        nodes[freeList].parent = NULL_NODE;
+    }
+
+    int32_t id = freeList;
+    Node& node = nodes[id];
+    freeList = node.parent;
+
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    node.userData = 0;
+    return id;
+}
+
+void DynamicTree::freeNode(int32_t id)
+{
+    nodes[id].parent = freeList;
+    nodes[id].height = -1;
+    freeList = id;
+}
+
+int32_t DynamicTree::createProxy(const AABB& box, uint32_t userData)
+{
+    int32_t id = allocateNode();
+
+    Vec2 pad{ margin, margin };
+    nodes[id].box = { box.min - pad, box.max + pad };
+    nodes[id].userData = userData;
+    nodes[id].height = 0;
+
+    insertLeaf(id);
+    return id;
+}
+
+void DynamicTree::destroyProxy(int32_t proxyId)
+{
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+}
+
+bool DynamicTree::moveProxy(int32_t proxyId, const AABB& box)
+{
+    if (nodes[proxyId].box.contains(box)) return false;
+
+    removeLeaf(proxyId);
+
+    Vec2 pad{ margin, margin };
+    nodes[proxyId].box = { box.min - pad, box.max + pad };
+
+    insertLeaf(proxyId);
+    return true;
+}
+
+int32_t DynamicTree::getHeight() const
+{
+    return root == NULL_NODE ? 0 : nodes[root].height;
+}
+
+void DynamicTree::save(SnapshotWriter& out) const
+{
+    out.write(nodes);
+    out.write(root);
+    out.write(freeList);
+}
+
+bool DynamicTree::restore(SnapshotReader& in)
+{
+    in.read(nodes);
+    in.read(root);
+    in.read(freeList);
+    return in.ok();
+}
+
+// ---------- INSERT / REMOVE ----------
+
+void DynamicTree::insertLeaf(int32_t leaf)
+{
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // ---------- FIND BEST SIBLING ----------
+    AABB leafBox = nodes[leaf].box;
+    int32_t index = root;
+
+    while (!nodes[index].isLeaf()) {
+        int32_t child1 = nodes[index].child1;
+        int32_t child2 = nodes[index].child2;
+
+        float area = nodes[index].box.perimeter();
+        float combinedArea = AABB::combine(nodes[index].box, leafBox).perimeter();
+
+        // cost of making a new parent for this node and the leaf
+        float cost = 2.f * combinedArea;
+        // minimum cost of pushing the leaf further down
+        float inheritanceCost = 2.f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child) {
+            float c = AABB::combine(leafBox, nodes[child].box).perimeter();
+            if (!nodes[child].isLeaf())
+                c -= nodes[child].box.perimeter();
+            return c + inheritanceCost;
+        };
+
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = (cost1 < cost2) ? child1 : child2;
+    }
+
+    int32_t sibling = index;
+
+    // ---------- NEW PARENT ----------
+    int32_t oldParent = nodes[sibling].parent;
+    int32_t newParent = allocateNode();
+
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = AABB::combine(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling)
+            nodes[oldParent].child1 = newParent;
+        else
+            nodes[oldParent].child2 = newParent;
+    } else {
+        root = newParent;
+    }
+
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    // ---------- REFIT + REBALANCE ----------
+    index = nodes[leaf].parent;
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = nodes[index];
+        const Node& c1 = nodes[node.child1];
+        const Node& c2 = nodes[node.child2];
+        node.height = 1 + std::max(c1.height, c2.height);
+        node.box = AABB::combine(c1.box, c2.box);
+
+        index = node.parent;
+    }
+}
+
+void DynamicTree::removeLeaf(int32_t leaf)
+{
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = (nodes[parent].child1 == leaf)
+        ? nodes[parent].child2
+        : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes[grandParent].child1 == parent)
+        nodes[grandParent].child1 = sibling;
+    else
+        nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int32_t index = grandParent;
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = nodes[index];
+        const Node& c1 = nodes[node.child1];
+        const Node& c2 = nodes[node.child2];
+        node.height = 1 + std::max(c1.height, c2.height);
+        node.box = AABB::combine(c1.box, c2.box);
+
+        index = node.parent;
+    }
+}
+
+// ---------- BALANCE ----------
+// Rotates the taller grandchild up when A's subtrees differ in height
+// by more than one. Returns the index of the new subtree root.
+int32_t DynamicTree::balance(int32_t iA)
+{
+    Node& A = nodes[iA];
+    if (A.isLeaf() || A.height < 2) return iA;
+
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    Node& B = nodes[iB];
+    Node& C = nodes[iC];
+
+    int32_t diff = C.height - B.height;
+
+    // ---------- ROTATE C UP ----------
+    if (diff > 1) {
+        int32_t iF = C.child1;
+        int32_t iG = C.child2;
+        Node& F = nodes[iF];
+        Node& G = nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != NULL_NODE) {
+            if (nodes[C.parent].child1 == iA)
+                nodes[C.parent].child1 = iC;
+            else
+                nodes[C.parent].child2 = iC;
+        } else {
+            root = iC;
+        }
+
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.box = AABB::combine(B.box, G.box);
+            C.box = AABB::combine(A.box, F.box);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.box = AABB::combine(B.box, F.box);
+            C.box = AABB::combine(A.box, G.box);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+        return iC;
+    }
+
+    // ---------- ROTATE B UP ----------
+    if (diff < -1) {
+        int32_t iD = B.child1;
+        int32_t iE = B.child2;
+        Node& D = nodes[iD];
+        Node& E = nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != NULL_NODE) {
+            if (nodes[B.parent].child1 == iA)
+                nodes[B.parent].child1 = iB;
+            else
+                nodes[B.parent].child2 = iB;
+        } else {
+            root = iB;
+        }
+
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.box = AABB::combine(C.box, E.box);
+            B.box = AABB::combine(A.box, D.box);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.box = AABB::combine(C.box, D.box);
+            B.box = AABB::combine(A.box, E.box);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
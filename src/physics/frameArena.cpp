@@ -0,0 +1,57 @@
+#include "physics/frameArena.h"
+
+FrameArena::FrameArena(size_t initialBytes)
+{
+    addBlock(initialBytes);
+}
+
+void FrameArena::reset()
+{
+    highWater = std::max(highWater, getUsed());
+
+    // the last step spilled over: replace the chain with one block,
+    // with headroom so a slightly bigger step doesn't spill again
+    if (blocks.size() > 1) {
+        blocks.clear();
+        addBlock(highWater + highWater / 2);
+    }
+
+    offset = 0;
+    usedBefore = 0;
+    generation++;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+    size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+    if (aligned + bytes > blocks.back().size) {
+        usedBefore += offset;
+        addBlock(std::max(bytes + alignment, blocks.back().size * 2));
+        aligned = 0;
+    }
+
+    offset = aligned + bytes;
+    return blocks.back().memory.get() + aligned;
+}
+
+size_t FrameArena::getUsed() const
+{
+    return usedBefore + offset;
+}
+
+size_t FrameArena::getCapacity() const
+{
+    size_t total = 0;
+    for (const Block& block : blocks)
+        total += block.size;
+    return total;
+}
+
+void FrameArena::addBlock(size_t minBytes)
+{
+    Block block;
+    block.size = minBytes;
+    block.memory.reset(new unsigned char[minBytes]);
+    blocks.push_back(std::move(block));
+    offset = 0;
+}
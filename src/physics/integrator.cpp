@@ -0,0 +1,166 @@
+#include "physics/integrator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INTEGRATOR_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+// the kernels treat Vec2 arrays as interleaved x, y floats
+static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 must be two packed floats");
+
+void buildAwakeRanges(const BodyStorage& bodies, std::vector<BodyRange>& ranges)
+{
+    ranges.clear();
+
+    const uint32_t n = static_cast<uint32_t>(bodies.size());
+    uint32_t i = 0;
+    while (i < n) {
+        while (i < n && !bodies.awake[i]) i++;
+        uint32_t begin = i;
+        while (i < n && bodies.awake[i]) i++;
+        if (i > begin)
+            ranges.push_back({ begin, i });
+    }
+}
+
+// ---------- SCALAR ----------
+static void integrateLinearVelocity(
+    float* velocity, float* force,
+    const float* invMass,
+    uint32_t begin, uint32_t end,
+    const Vec2& gravity, float dt
+) {
+    for (uint32_t i = begin; i < end; i++) {
+        float ax = gravity.x + force[2 * i]     * invMass[i];
+        float ay = gravity.y + force[2 * i + 1] * invMass[i];
+
+        velocity[2 * i]     += ax * dt;
+        velocity[2 * i + 1] += ay * dt;
+        force[2 * i]     = 0.f;
+        force[2 * i + 1] = 0.f;
+    }
+}
+
+// Positions (as interleaved x, y) and rotations share one loop:
+// state += rate * dt over a flat float range.
+static void integrateState(
+    float* state, const float* rate,
+    uint32_t begin, uint32_t end, float dt
+) {
+    for (uint32_t i = begin; i < end; i++)
+        state[i] += rate[i] * dt;
+}
+
+#ifdef INTEGRATOR_SSE2
+// ---------- SSE2 ----------
+// Linear state two bodies per register: {x0, y0, x1, y1}.
+// Returns where the scalar tail has to pick up.
+static uint32_t integrateLinearVelocitySSE2(
+    float* velocity, float* force,
+    const float* invMass,
+    uint32_t begin, uint32_t end,
+    const Vec2& gravity, float dt
+) {
+    const __m128 g = _mm_setr_ps(gravity.x, gravity.y, gravity.x, gravity.y);
+    const __m128 h = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+
+    uint32_t i = begin;
+    for (; i + 2 <= end; i += 2) {
+        // {m0, m0, m1, m1}
+        __m128 m = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(invMass + i)));
+        m = _mm_unpacklo_ps(m, m);
+
+        __m128 f = _mm_loadu_ps(force + 2 * i);
+        __m128 v = _mm_loadu_ps(velocity + 2 * i);
+
+        __m128 a = _mm_add_ps(g, _mm_mul_ps(f, m));
+        v = _mm_add_ps(v, _mm_mul_ps(a, h));
+
+        _mm_storeu_ps(velocity + 2 * i, v);
+        _mm_storeu_ps(force + 2 * i, zero);
+    }
+    return i;
+}
+
+// Four floats per register: two positions or four rotations.
+static uint32_t integrateStateSSE2(
+    float* state, const float* rate,
+    uint32_t begin, uint32_t end, float dt
+) {
+    const __m128 h = _mm_set1_ps(dt);
+
+    uint32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(state + i);
+        __m128 v = _mm_loadu_ps(rate + i);
+        _mm_storeu_ps(state + i, _mm_add_ps(x, _mm_mul_ps(v, h)));
+    }
+    return i;
+}
+#endif
+
+void integrateVelocities(
+    BodyStorage& bodies,
+    const BodyRange* ranges, size_t rangeCount,
+    const Vec2& gravity, float dt
+) {
+    float* velocity = &bodies.velocity.data()->x;
+    float* force    = &bodies.force.data()->x;
+    const float* invMass = bodies.invMass.data();
+
+    for (size_t r = 0; r < rangeCount; r++) {
+        uint32_t i = ranges[r].begin;
+        const uint32_t end = ranges[r].end;
+
+#ifdef INTEGRATOR_SSE2
+        i = integrateLinearVelocitySSE2(velocity, force, invMass, i, end, gravity, dt);
+#endif
+        integrateLinearVelocity(velocity, force, invMass, i, end, gravity, dt);
+    }
+}
+
+void integratePositions(
+    BodyStorage& bodies,
+    const BodyRange* ranges, size_t rangeCount,
+    float dt
+) {
+    float* position = &bodies.position.data()->x;
+    const float* velocity = &bodies.velocity.data()->x;
+    float* rotation = bodies.rotation.data();
+    const float* angularVelocity = bodies.angularVelocity.data();
+
+    for (size_t r = 0; r < rangeCount; r++) {
+        // positions are walked as 2 * count interleaved floats
+        uint32_t linear  = 2 * ranges[r].begin;
+        uint32_t angular = ranges[r].begin;
+        const uint32_t linearEnd = 2 * ranges[r].end;
+        const uint32_t end = ranges[r].end;
+
+#ifdef INTEGRATOR_SSE2
+        linear  = integrateStateSSE2(position, velocity, linear, linearEnd, dt);
+        angular = integrateStateSSE2(rotation, angularVelocity, angular, end, dt);
+#endif
+        integrateState(position, velocity, linear, linearEnd, dt);
+        integrateState(rotation, angularVelocity, angular, end, dt);
+    }
+}
+
+void integratePseudoVelocities(
+    BodyStorage& bodies, const Vec2* pseudoVelocity,
+    const BodyRange* ranges, size_t rangeCount,
+    float dt
+) {
+    float* position = &bodies.position.data()->x;
+    const float* velocity = &pseudoVelocity->x;
+
+    for (size_t r = 0; r < rangeCount; r++) {
+        uint32_t i = 2 * ranges[r].begin;
+        const uint32_t end = 2 * ranges[r].end;
+
+#ifdef INTEGRATOR_SSE2
+        i = integrateStateSSE2(position, velocity, i, end, dt);
+#endif
+        integrateState(position, velocity, i, end, dt);
+    }
+}
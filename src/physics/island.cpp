@@ -0,0 +1,89 @@
+#include "physics/island.h"
+
+static constexpr uint32_t NO_ISLAND = UINT32_MAX;
+
+uint32_t IslandBuilder::findRoot(uint32_t i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]]; // path halving
+        i = parent[i];
+    }
+    return i;
+}
+
+void IslandBuilder::build(
+    const BodyStorage& bodies,
+    const FrameVector<Contact>& contacts,
+    IslandSet& islands
+) {
+    const uint32_t n = static_cast<uint32_t>(bodies.size());
+
+    auto simulated = [&](uint32_t i) {
+        return bodies.invMass[i] > 0.f && bodies.awake[i];
+    };
+
+    // ---------- UNION-FIND OVER CONTACTS ----------
+    parent.resize(n);
+    for (uint32_t i = 0; i < n; i++)
+        parent[i] = i;
+
+    for (const auto& c : contacts) {
+        if (!simulated(c.a) || !simulated(c.b)) continue;
+
+        uint32_t rootA = findRoot(c.a);
+        uint32_t rootB = findRoot(c.b);
+        if (rootA == rootB) continue;
+
+        // lowest index wins, keeps island order stable
+        if (rootA < rootB) parent[rootB] = rootA;
+        else               parent[rootA] = rootB;
+    }
+
+    // ---------- LABEL ISLANDS ----------
+    islandOf.assign(n, NO_ISLAND);
+    uint32_t islandCount = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!simulated(i)) continue;
+
+        uint32_t root = findRoot(i);
+        if (islandOf[root] == NO_ISLAND)
+            islandOf[root] = islandCount++;
+        islandOf[i] = islandOf[root];
+    }
+
+    // ---------- COUNTING SORT: BODIES ----------
+    islands.bodyStart.assign(islandCount + 1, 0);
+    for (uint32_t i = 0; i < n; i++)
+        if (islandOf[i] != NO_ISLAND)
+            islands.bodyStart[islandOf[i] + 1]++;
+    for (uint32_t k = 0; k < islandCount; k++)
+        islands.bodyStart[k + 1] += islands.bodyStart[k];
+
+    islands.bodies.resize(islands.bodyStart[islandCount]);
+    cursor.assign(islands.bodyStart.begin(), islands.bodyStart.end() - 1);
+    for (uint32_t i = 0; i < n; i++)
+        if (islandOf[i] != NO_ISLAND)
+            islands.bodies[cursor[islandOf[i]]++] = i;
+
+    // ---------- COUNTING SORT: CONTACTS ----------
+    // a contact belongs to the island of whichever body is simulated
+    auto contactIsland = [&](const Contact& c) {
+        return islandOf[c.a] != NO_ISLAND ? islandOf[c.a] : islandOf[c.b];
+    };
+
+    islands.contactStart.assign(islandCount + 1, 0);
+    for (const auto& c : contacts) {
+        uint32_t k = contactIsland(c);
+        if (k != NO_ISLAND) islands.contactStart[k + 1]++;
+    }
+    for (uint32_t k = 0; k < islandCount; k++)
+        islands.contactStart[k + 1] += islands.contactStart[k];
+
+    islands.contacts.resize(islands.contactStart[islandCount]);
+    cursor.assign(islands.contactStart.begin(), islands.contactStart.end() - 1);
+    for (uint32_t ci = 0; ci < contacts.size(); ci++) {
+        uint32_t k = contactIsland(contacts[ci]);
+        if (k != NO_ISLAND)
+            islands.contacts[cursor[k]++] = ci;
+    }
+}
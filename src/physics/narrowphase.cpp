@@ -0,0 +1,245 @@
+#include "physics/narrowphase.h"
+#include "physics/collisions.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+// Turns narrowphase geometry into solver-ready contacts, one per
+// manifold point: effective masses, combined materials and restitution
+// target. Manifold lookup and warm starting are left to the world.
+static void addContact(
+    const BodyStorage& bodies,
+    float restingSpeed,
+    uint32_t a, uint32_t b,
+    const ContactGeometry& geometry,
+    FrameVector<Contact>& out
+) {
+    Contact c;
+    c.invMassA = bodies.invMass[a];
+    c.invMassB = bodies.invMass[b];
+    if (c.invMassA + c.invMassB == 0.f) return;
+
+    c.a = a;
+    c.b = b;
+    c.normal = geometry.normal;
+    c.invInertiaA = bodies.invInertia[a];
+    c.invInertiaB = bodies.invInertia[b];
+
+    // -------- MATERIALS --------
+    c.staticFriction = std::sqrt(
+        bodies.staticFriction[a] * bodies.staticFriction[a] +
+        bodies.staticFriction[b] * bodies.staticFriction[b]);
+
+    c.dynamicFriction = std::sqrt(
+        bodies.dynamicFriction[a] * bodies.dynamicFriction[a] +
+        bodies.dynamicFriction[b] * bodies.dynamicFriction[b]);
+
+    float restitution = std::min(bodies.restitution[a], bodies.restitution[b]);
+    Vec2 tangent = perp(c.normal);
+
+    for (int k = 0; k < geometry.pointCount; k++) {
+        c.point = static_cast<uint8_t>(k);
+        c.id = geometry.id[k];
+        c.penetration = geometry.penetration[k];
+        c.rA = geometry.points[k] - bodies.position[a];
+        c.rB = geometry.points[k] - bodies.position[b];
+
+        // -------- EFFECTIVE MASSES --------
+        float rnA = cross(c.rA, c.normal);
+        float rnB = cross(c.rB, c.normal);
+        c.normalMass = 1.f / (
+            c.invMassA + c.invMassB +
+            rnA * rnA * c.invInertiaA +
+            rnB * rnB * c.invInertiaB);
+
+        float rtA = cross(c.rA, tangent);
+        float rtB = cross(c.rB, tangent);
+        c.tangentMass = 1.f / (
+            c.invMassA + c.invMassB +
+            rtA * rtA * c.invInertiaA +
+            rtB * rtB * c.invInertiaB);
+
+        // -------- RESTITUTION TARGET --------
+        Vec2 velA = bodies.velocity[a] + perp(c.rA) * bodies.angularVelocity[a];
+        Vec2 velB = bodies.velocity[b] + perp(c.rB) * bodies.angularVelocity[b];
+        float vn = (velB - velA).dot(c.normal);
+
+        c.velocityBias = (vn < -restingSpeed) ? -restitution * vn : 0.f;
+
+        out.push_back(c);
+    }
+}
+
+// ---------- SHAPE PAIR COLLIDERS ----------
+// One specialisation per bucket, first type <= second type. Geometry
+// normals point from a to b.
+template <ColliderType A, ColliderType B>
+struct ShapePairCollider;
+
+template <>
+struct ShapePairCollider<ColliderType::Circle, ColliderType::Circle> {
+    static bool collide(const BodyStorage& bodies, uint32_t a, uint32_t b, ContactGeometry& geometry) {
+        return collideCircles(
+            bodies.position[a], bodies.halfExtents[a].x,
+            bodies.position[b], bodies.halfExtents[b].x,
+            geometry);
+    }
+};
+
+template <>
+struct ShapePairCollider<ColliderType::Circle, ColliderType::Polygon> {
+    static bool collide(const BodyStorage& bodies, uint32_t a, uint32_t b, ContactGeometry& geometry) {
+        return collideCirclePolygon(
+            bodies.position[a], bodies.halfExtents[a].x,
+            bodies.polygons[bodies.polygon[b]],
+            Transform(bodies.position[b], bodies.rotation[b]),
+            geometry);
+    }
+};
+
+template <>
+struct ShapePairCollider<ColliderType::Polygon, ColliderType::Polygon> {
+    static bool collide(const BodyStorage& bodies, uint32_t a, uint32_t b, ContactGeometry& geometry) {
+        return collidePolygons(
+            bodies.polygons[bodies.polygon[a]],
+            Transform(bodies.position[a], bodies.rotation[a]),
+            bodies.polygons[bodies.polygon[b]],
+            Transform(bodies.position[b], bodies.rotation[b]),
+            geometry);
+    }
+};
+
+// ---------- BUCKET KERNELS ----------
+template <ColliderType A, ColliderType B>
+static void collideRun(
+    const BodyStorage& bodies, float restingSpeed,
+    const BroadphasePair* pairs, size_t count,
+    FrameVector<Contact>& out, NarrowphaseScratch&
+) {
+    ContactGeometry geometry;
+    for (size_t p = 0; p < count; p++) {
+        uint32_t a = pairs[p].a;
+        uint32_t b = pairs[p].b;
+        if (ShapePairCollider<A, B>::collide(bodies, a, b, geometry))
+            addContact(bodies, restingSpeed, a, b, geometry, out);
+    }
+}
+
+// Circles are screened by the SIMD overlap kernel first; only its hits
+// get the exact test.
+template <>
+void collideRun<ColliderType::Circle, ColliderType::Circle>(
+    const BodyStorage& bodies, float restingSpeed,
+    const BroadphasePair* pairs, size_t count,
+    FrameVector<Contact>& out, NarrowphaseScratch& scratch
+) {
+    using Collider = ShapePairCollider<ColliderType::Circle, ColliderType::Circle>;
+
+    CircleBatch& batch = scratch.circles;
+    batch.clear();
+    for (size_t p = 0; p < count; p++) {
+        uint32_t a = pairs[p].a;
+        uint32_t b = pairs[p].b;
+        batch.push(bodies.position[a], bodies.position[b],
+            bodies.halfExtents[a].x + bodies.halfExtents[b].x);
+    }
+    batch.findOverlaps();
+
+    ContactGeometry geometry;
+    for (uint32_t hit : batch.hits) {
+        uint32_t a = pairs[hit].a;
+        uint32_t b = pairs[hit].b;
+        if (Collider::collide(bodies, a, b, geometry))
+            addContact(bodies, restingSpeed, a, b, geometry, out);
+    }
+}
+
+// ---------- DISPATCH TABLE ----------
+using RunKernel = void (*)(
+    const BodyStorage&, float,
+    const BroadphasePair*, size_t,
+    FrameVector<Contact>&, NarrowphaseScratch&);
+
+// Inverse of shapePairIndex.
+constexpr ColliderType pairFirst(uint32_t k)
+{
+    uint32_t i = 0;
+    while (shapePairIndex(static_cast<ColliderType>(i + 1), static_cast<ColliderType>(i + 1)) <= k &&
+           i + 1 < COLLIDER_TYPE_COUNT)
+        i++;
+    return static_cast<ColliderType>(i);
+}
+
+constexpr ColliderType pairSecond(uint32_t k)
+{
+    ColliderType first = pairFirst(k);
+    return static_cast<ColliderType>(
+        static_cast<uint32_t>(first) + (k - shapePairIndex(first, first)));
+}
+
+template <uint32_t... K>
+constexpr auto makeKernelTable(std::integer_sequence<uint32_t, K...>)
+{
+    return std::array<RunKernel, sizeof...(K)>{{ &collideRun<pairFirst(K), pairSecond(K)>... }};
+}
+
+static constexpr auto kernels =
+    makeKernelTable(std::make_integer_sequence<uint32_t, SHAPE_PAIR_COUNT>{});
+
+// ---------- BUCKETING ----------
+void PairBuckets::build(FrameArena& arena, const BodyStorage& bodies,
+    const FrameVector<BroadphasePair>& candidates)
+{
+    static constexpr uint8_t SKIP = UINT8_MAX;
+
+    std::fill(std::begin(start), std::end(start), 0u);
+
+    // lower shape type first, counting sort by bucket
+    uint8_t* bucketOf = arena.allocate<uint8_t>(candidates.size());
+    for (size_t p = 0; p < candidates.size(); p++) {
+        const BroadphasePair& pair = candidates[p];
+        if (!bodies.awake[pair.a] && !bodies.awake[pair.b]) {
+            bucketOf[p] = SKIP;
+            continue;
+        }
+
+        ColliderType typeA = bodies.type[pair.a];
+        ColliderType typeB = bodies.type[pair.b];
+        uint32_t k = typeA <= typeB ? shapePairIndex(typeA, typeB) : shapePairIndex(typeB, typeA);
+        bucketOf[p] = static_cast<uint8_t>(k);
+        start[k + 1]++;
+    }
+    for (uint32_t k = 0; k < SHAPE_PAIR_COUNT; k++)
+        start[k + 1] += start[k];
+
+    uint32_t cursor[SHAPE_PAIR_COUNT];
+    std::copy(start, start + SHAPE_PAIR_COUNT, cursor);
+
+    pairs = arena.allocate<BroadphasePair>(size());
+    for (size_t p = 0; p < candidates.size(); p++) {
+        if (bucketOf[p] == SKIP) continue;
+
+        BroadphasePair pair = candidates[p];
+        if (bodies.type[pair.a] > bodies.type[pair.b])
+            std::swap(pair.a, pair.b);
+        pairs[cursor[bucketOf[p]]++] = pair;
+    }
+}
+
+void collideBuckets(
+    const BodyStorage& bodies,
+    float restingSpeed,
+    const PairBuckets& buckets,
+    uint32_t begin, uint32_t end,
+    FrameVector<Contact>& out,
+    NarrowphaseScratch& scratch
+) {
+    for (uint32_t k = 0; k < SHAPE_PAIR_COUNT; k++) {
+        uint32_t first = std::max(begin, buckets.start[k]);
+        uint32_t last  = std::min(end, buckets.start[k + 1]);
+        if (first < last)
+            kernels[k](bodies, restingSpeed, buckets.pairs + first, last - first, out, scratch);
+    }
+}
@@ -1,455 +1,1189 @@
 #include "physics/physicsWorld.h"
 #include "math/math_utils.h"
 #include "physics/collisions.h"
+#include "physics/contactSolver.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <iostream>
 
-void PhysicsWorld::add(RigidBody* body, CircleCollider* collider)
+// Below these sizes the task pool costs more than it saves.
+static constexpr size_t   MIN_PARALLEL_PAIRS = 256;
+static constexpr uint32_t MIN_PAIR_GRAIN = 64;
+static constexpr uint32_t MIN_COLOR_GRAIN = 32;
+
+// Islands with at least this many contacts are solved colour by colour.
+static constexpr size_t MIN_COLORED_ISLAND_CONTACTS = 256;
+
+// ---------- BODIES ----------
+BodyHandle PhysicsWorld::createBody(const RigidBody& body, const CircleCollider& collider)
 {
+    RigidBody def = body;
+
     // --- inertia for circle ---
-    if (body->invMass == 0.f) {
-        body->inertia = 0.f;
-        body->invInertia = 0.f;
+    if (def.invMass == 0.f) {
+        def.inertia = 0.f;
+        def.invInertia = 0.f;
     } else {
-        float r = collider->radius;
-        body->inertia = 0.5f * body->mass * r * r;
-        body->invInertia = 1.f / body->inertia;
+        float r = collider.radius;
+        def.inertia = 0.5f * def.mass * r * r;
+        def.invInertia = 1.f / def.inertia;
     }
 
-    objects.push_back({ body, ColliderType::Circle, collider });
+    uint32_t i = bodies.push(
+        def, ColliderType::Circle,
+        { collider.radius, collider.radius },
+        collider.restitution,
+        collider.staticFriction,
+        collider.dynamicFriction);
+
+    treeDirty = true;
+    boundsStale = true;
+    awakeRangesDirty = true;
+    return bodies.handleOf(i);
 }
 
-void PhysicsWorld::add(RigidBody* body, BoxCollider* collider)
+BodyHandle PhysicsWorld::createBody(const RigidBody& body, const BoxCollider& collider)
 {
-    // --- inertia for box ---
-    if (body->invMass == 0.f) {
-        body->inertia = 0.f;
-        body->invInertia = 0.f;
-    } else {
-        float w = collider->halfWidth * 2.f;
-        float h = collider->halfHeight * 2.f;
-        body->inertia = (1.f / 12.f) * body->mass * (w*w + h*h);
-        body->invInertia = 1.f / body->inertia;
-    }
-
-    objects.push_back({ body, ColliderType::Box, collider });
+    return createPolygon(body, makeBox(collider.halfWidth, collider.halfHeight),
+        collider.restitution, collider.staticFriction, collider.dynamicFriction);
 }
 
-void PhysicsWorld::step(float dt)
+BodyHandle PhysicsWorld::createBody(const RigidBody& body, const PolygonCollider& collider)
 {
-    integrate(dt);
-    for (int k = 0; k < 4; k++)
-        solveCollisions();
+    Polygon polygon;
+    Vec2 centroid;
+    int count = static_cast<int>(collider.vertices.size());
+    if (!makePolygon(collider.vertices.data(), count, polygon, centroid))
+        return {};
+
+    // the body origin sits on the centroid
+    RigidBody def = body;
+    def.position += Transform(def.position, def.rotation).rotate(centroid);
+
+    return createPolygon(def, polygon,
+        collider.restitution, collider.staticFriction, collider.dynamicFriction);
+}
 
+BodyHandle PhysicsWorld::createCircle(const Vec2& position, float radius, float mass)
+{
+    return createBody(RigidBody(position, mass), CircleCollider{ radius });
 }
 
-void PhysicsWorld::integrate(float dt)
+BodyHandle PhysicsWorld::createBox(const Vec2& position, float halfWidth, float halfHeight, float mass)
 {
-    for (auto& obj : objects) {
-        if (obj.body->invMass == 0.f) continue;
+    return createBody(RigidBody(position, mass), BoxCollider{ halfWidth, halfHeight });
+}
 
-        obj.body->applyForce(gravity * obj.body->mass);
-        obj.body->integrate(dt);
+BodyHandle PhysicsWorld::createPolygon(
+    RigidBody def,
+    const Polygon& polygon,
+    float restitution,
+    float staticFriction,
+    float dynamicFriction
+) {
+    // --- inertia for polygon ---
+    if (def.invMass == 0.f) {
+        def.inertia = 0.f;
+        def.invInertia = 0.f;
+    } else {
+        def.inertia = polygonInertia(polygon, def.mass);
+        def.invInertia = 1.f / def.inertia;
     }
+
+    uint32_t i = bodies.push(
+        def, ColliderType::Polygon,
+        { polygon.radius, polygon.radius },
+        restitution,
+        staticFriction,
+        dynamicFriction,
+        &polygon);
+
+    treeDirty = true;
+    boundsStale = true;
+    awakeRangesDirty = true;
+    return bodies.handleOf(i);
 }
 
-void PhysicsWorld::solveCollisions()
+// Every per-body array the world keeps between steps follows the
+// storage's swap-and-pop: the moved body's bounds, tree proxy and grid
+// entries are re-pointed at its new index. Sweep and prune drops the
+// stale index on its own. Contact manifolds are keyed by slot, so the
+// moved body keeps its warm start and the removed one's manifolds go
+// stale at the next step.
+bool PhysicsWorld::destroy(BodyHandle body)
 {
-    for (size_t i = 0; i < objects.size(); i++) {
-        for (size_t j = i + 1; j < objects.size(); j++) {
+    if (!bodies.contains(body)) return false;
 
-            auto& A = objects[i];
-            auto& B = objects[j];
+    const uint32_t i = bodies.indexOf(body);
+    wakeTouching(i);
 
-            if (A.type == ColliderType::Circle &&
-                B.type == ColliderType::Circle)
-            {
-                auto* cA = static_cast<CircleCollider*>(A.collider);
-                auto* cB = static_cast<CircleCollider*>(B.collider);
-                if (circleVsCircle(
-                    A.body->position, *cA,
-                    B.body->position, *cB))
-                {
-                    resolveCircleVsCircle(A, B);
-                }
-                
-            }
-            else if (A.type == ColliderType::Circle &&
-                    B.type == ColliderType::Box)
-            {
-                auto* c = static_cast<CircleCollider*>(A.collider);
-                auto* b = static_cast<BoxCollider*>(B.collider);
-
-                if (circleVsBox(
-                    A.body->position, c->radius,
-                    B.body->position, *b))
-                {
-                    resolveCircleVsBox(A, B);
-                }
-            }
-            else if (A.type == ColliderType::Box &&
-                    B.type == ColliderType::Circle)
-            {
-                auto* c = static_cast<CircleCollider*>(B.collider);
-                auto* b = static_cast<BoxCollider*>(A.collider);
-
-                if (circleVsBox(
-                        B.body->position, c->radius,
-                        A.body->position, *b))
-                {
-                    resolveCircleVsBox(B, A); // swap for resolution too
-                }
-            }
-            else if (A.type == ColliderType::Box &&
-                    B.type == ColliderType::Box)
-            {
-                auto* bA = static_cast<BoxCollider*>(A.collider);
-                auto* bB = static_cast<BoxCollider*>(B.collider);
-
-                if (AABBvsAABB(
-                        A.body->position, *bA,
-                        B.body->position, *bB))
-                {
-                    resolveAABBvsAABB(A, B);
-                }
-            }
-        }
+    if (bodies.proxyId[i] != DynamicTree::NULL_NODE)
+        tree.destroyProxy(bodies.proxyId[i]);
+    spatialGrid.removeProxy(i);
+
+    const uint32_t moved = bodies.remove(i);
+    if (bounds.size() > moved) {
+        bounds[i] = bounds[moved];
+        bounds.pop_back();
     }
+    if (moved != i && bodies.proxyId[i] != DynamicTree::NULL_NODE)
+        tree.setUserData(bodies.proxyId[i], i);
+
+    awakeRangesDirty = true;
+    return true;
 }
-void PhysicsWorld::resolveCircleVsCircle(
-    PhysicsObject& A,
-    PhysicsObject& B)
+
+// Bodies asleep on i would otherwise hang in the air once it is gone
+// or has been moved away. Uses i's bounds from before the change.
+// Awake neighbours notice by themselves, so an awake i costs nothing.
+void PhysicsWorld::wakeTouching(uint32_t i)
 {
-    auto* cA = static_cast<CircleCollider*>(A.collider);
-    auto* cB = static_cast<CircleCollider*>(B.collider);
+    if (bodies.awake[i] || bounds.size() != bodies.size()) return;
 
-    Vec2 delta = B.body->position - A.body->position;
-    float dist = delta.magnitude();
-    if (dist <= 0.f) return;
+    for (uint32_t j = 0; j < bodies.size(); j++)
+        if (j != i && !bodies.awake[j] && bounds[i].overlaps(bounds[j]))
+            wakeBody(j);
+}
 
-    Vec2 normal = delta / dist;
-    float penetration = (cA->radius + cB->radius) - dist;
-    if (penetration <= 0.f) return;
+void PhysicsWorld::wake(BodyHandle body)
+{
+    wakeBody(bodies.indexOf(body));
+}
 
-    float invMassA = A.body->invMass;
-    float invMassB = B.body->invMass;
-    float totalInvMass = invMassA + invMassB;
-    if (totalInvMass == 0.f) return;
+void PhysicsWorld::wakeBody(uint32_t i)
+{
+    if (bodies.invMass[i] == 0.f) return; // static bodies never wake
 
-    // -------- CONTACT POINT --------
-    Vec2 contactPoint =
-        A.body->position + normal * cA->radius;
+    if (!bodies.awake[i]) awakeRangesDirty = true;
+    bodies.awake[i] = 1;
+    bodies.sleepTime[i] = 0.f;
+}
 
-    Vec2 rA = contactPoint - A.body->position;
-    Vec2 rB = contactPoint - B.body->position;
+void PhysicsWorld::setPosition(BodyHandle body, const Vec2& position)
+{
+    uint32_t i = bodies.indexOf(body);
+    wakeTouching(i);
+    bodies.position[i] = position;
+    bodies.previousPosition[i] = position; // teleports don't interpolate
+    wakeBody(i);
+    treeDirty = true;
+    boundsStale = true;
+}
 
-    // -------- RELATIVE VELOCITY (WITH ROTATION) --------
-    Vec2 velA = A.body->velocity +
-                perp(rA) * A.body->angularVelocity;
+void PhysicsWorld::setVelocity(BodyHandle body, const Vec2& velocity)
+{
+    uint32_t i = bodies.indexOf(body);
+    bodies.velocity[i] = velocity;
+    wakeBody(i);
+}
 
-    Vec2 velB = B.body->velocity +
-                perp(rB) * B.body->angularVelocity;
+void PhysicsWorld::setAngularVelocity(BodyHandle body, float angularVelocity)
+{
+    uint32_t i = bodies.indexOf(body);
+    bodies.angularVelocity[i] = angularVelocity;
+    wakeBody(i);
+}
 
-    Vec2 rv = velB - velA;
-    float vn = rv.dot(normal);
+void PhysicsWorld::setRotation(BodyHandle body, float rotation)
+{
+    uint32_t i = bodies.indexOf(body);
+    wakeTouching(i);
+    bodies.rotation[i] = rotation;
+    bodies.previousRotation[i] = rotation;
+    wakeBody(i);
+    treeDirty = true;
+    boundsStale = true;
+}
 
-    // -------- NORMAL IMPULSE --------
-    float j = 0.f;
-    if (vn < 0.f) {
-        float restitution = std::min(cA->restitution, cB->restitution);
-        if (std::abs(vn) < 0.3f) restitution = 0.f;
+void PhysicsWorld::setBullet(BodyHandle body, bool bullet)
+{
+    bodies.bullet[bodies.indexOf(body)] = bullet ? 1 : 0;
+}
 
-        float rnA = cross(rA, normal);
-        float rnB = cross(rB, normal);
+void PhysicsWorld::applyForce(BodyHandle body, const Vec2& force)
+{
+    uint32_t i = bodies.indexOf(body);
+    bodies.force[i] += force;
+    wakeBody(i);
+}
 
-        float denom =
-            invMassA + invMassB +
-            rnA * rnA * A.body->invInertia +
-            rnB * rnB * B.body->invInertia;
+void PhysicsWorld::applyImpulse(
+    BodyHandle body,
+    const Vec2& impulse,
+    const Vec2& contactVector
+) {
+    uint32_t i = bodies.indexOf(body);
+    if (bodies.invMass[i] == 0.f) return;
+
+    wakeBody(i);
+    bodies.velocity[i] += impulse * bodies.invMass[i];
+    bodies.angularVelocity[i] +=
+        cross(contactVector, impulse) * bodies.invInertia[i];
+}
 
-        j = -(1.f + restitution) * vn / denom;
+Vec2 PhysicsWorld::getInterpolatedPosition(BodyHandle body) const
+{
+    uint32_t i = bodies.indexOf(body);
+    const Vec2& from = bodies.previousPosition[i];
+    return from + (bodies.position[i] - from) * getInterpolationAlpha();
+}
 
-        Vec2 impulse = normal * j;
-        A.body->velocity -= impulse * invMassA;
-        B.body->velocity += impulse * invMassB;
+float PhysicsWorld::getInterpolatedRotation(BodyHandle body) const
+{
+    uint32_t i = bodies.indexOf(body);
+    const float from = bodies.previousRotation[i];
+    return from + (bodies.rotation[i] - from) * getInterpolationAlpha();
+}
+
+size_t PhysicsWorld::getAwakeBodyCount() const
+{
+    size_t count = 0;
+    for (uint8_t awake : bodies.awake)
+        count += awake;
+    return count;
+}
+
+// ---------- FIXED TIMESTEP ----------
+// The budget check predicts the next step from the average so far, so
+// a frame stops before going over rather than after.
+int PhysicsWorld::advance(float frameTime)
+{
+    using Clock = std::chrono::steady_clock;
+
+    accumulator += std::max(frameTime, 0.f);
+
+    const Clock::time_point start = Clock::now();
+    int steps = 0;
+    while (accumulator >= fixedTimeStep && steps < maxStepsPerFrame) {
+        if (steps > 0 && stepTimeBudget > 0.f) {
+            float elapsed = std::chrono::duration<float>(Clock::now() - start).count();
+            if (elapsed + elapsed / steps > stepTimeBudget) break;
+        }
+        step(fixedTimeStep);
+        accumulator -= fixedTimeStep;
+        steps++;
     }
 
-    // -------- FRICTION --------
-    Vec2 velA2 = A.body->velocity +
-                 perp(rA) * A.body->angularVelocity;
+    // Behind: drop the whole steps, keep the fraction so the
+    // interpolation alpha carries on smoothly.
+    if (accumulator >= fixedTimeStep)
+        accumulator = std::fmod(accumulator, fixedTimeStep);
+    return steps;
+}
 
-    Vec2 velB2 = B.body->velocity +
-                 perp(rB) * B.body->angularVelocity;
+void PhysicsWorld::step(float dt)
+{
+    stepCount++;
 
-    Vec2 rv2 = velB2 - velA2;
-    float vn2 = rv2.dot(normal);
+    std::copy(bodies.position.begin(), bodies.position.end(), bodies.previousPosition.begin());
+    std::copy(bodies.rotation.begin(), bodies.rotation.end(), bodies.previousRotation.begin());
 
-    Vec2 tangent = rv2 - normal * vn2;
-    float tMag = tangent.magnitude();
+#if PHYSICS_PROFILING
+    if (profiling) beginProfile();
+#endif
 
-    if (tMag > 1e-4f) {
-        tangent /= tMag;
+    beginFrame();
 
-        float jt = -rv2.dot(tangent);
+    // Slower approaches are resting contact and get no bounce; two
+    // steps' worth of gravity keeps warm-started stacks from hopping.
+    restingSpeed = std::max(restitutionThreshold, 2.f * gravity.magnitude() * dt);
 
-        float rtA = cross(rA, tangent);
-        float rtB = cross(rB, tangent);
+    // ---------- BROADPHASE + NARROWPHASE (once) ----------
+    // the substepped solver spreads gravity over its substeps; forces
+    // act over the whole step either way
+    integrateVelocities(dt, solver == SolverType::Substeps ? Vec2{} : gravity);
+    findPairs();
+    generateContacts();
 
-        float denomT =
-            invMassA + invMassB +
-            rtA * rtA * A.body->invInertia +
-            rtB * rtB * B.body->invInertia;
+    // ---------- ISLAND SOLVE ----------
+    // velocity iterations, then bodies move with the solved
+    // velocities, then position correction
+    buildIslands();
+    solveIslands(dt);
 
-        jt /= denomT;
+    storeImpulses();
+    contactCache.removeStale(stepCount);
+    bodies.releaseRetiredSlots();
 
-        float muS = std::sqrt(
-            cA->staticFriction * cA->staticFriction +
-            cB->staticFriction * cB->staticFriction);
+    updateSleep(dt);
+    treeDirty = true;
 
-        float muD = std::sqrt(
-            cA->dynamicFriction * cA->dynamicFriction +
-            cB->dynamicFriction * cB->dynamicFriction);
+#if PHYSICS_PROFILING
+    if (profiling) endProfile();
+#endif
+}
 
-        Vec2 frictionImpulse;
-        if (std::abs(jt) < j * muS)
-            frictionImpulse = tangent * jt;
-        else
-            frictionImpulse = tangent * -j * muD;
+// ---------- PROFILING ----------
+#if PHYSICS_PROFILING
+void PhysicsWorld::setProfileCapacity(size_t frames)
+{
+    profileHistory.setCapacity(frames);
+}
 
-        A.body->velocity -= frictionImpulse * invMassA;
-        B.body->velocity += frictionImpulse * invMassB;
+const ProfileHistory& PhysicsWorld::getProfileHistory() const
+{
+    return profileHistory;
+}
 
-        // 🔥 TORQUE FROM FRICTION
-        A.body->angularVelocity -=
-            cross(rA, frictionImpulse) * A.body->invInertia;
-        B.body->angularVelocity +=
-            cross(rB, frictionImpulse) * B.body->invInertia;
-    }
+void PhysicsWorld::beginProfile()
+{
+    currentProfile = StepProfile{};
+    currentProfile.step = stepCount;
+    profileStart = std::chrono::steady_clock::now();
+}
+
+void PhysicsWorld::endProfile()
+{
+    currentProfile.totalNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - profileStart).count());
+
+    currentProfile.pairs = static_cast<uint32_t>(pairs.size());
+    currentProfile.pairsTested = pairBuckets.size();
+    currentProfile.contacts = static_cast<uint32_t>(contacts.size());
+    currentProfile.activeBodies = static_cast<uint32_t>(islands.bodies.size());
+    currentProfile.islands = static_cast<uint32_t>(islands.count());
+    currentProfile.sweptBodies = static_cast<uint32_t>(sweptBodies.size());
+
+    size_t frameBytes = frameArena.getUsed();
+    for (const auto& arena : threadArenas)
+        frameBytes += arena->getUsed();
+    currentProfile.frameBytes = static_cast<uint32_t>(frameBytes);
+
+    profileHistory.push(currentProfile);
+}
+#else
+void PhysicsWorld::setProfileCapacity(size_t) {}
+
+const ProfileHistory& PhysicsWorld::getProfileHistory() const
+{
+    static const ProfileHistory empty(1);
+    return empty;
+}
+#endif
+
+// ---------- STATE HASH ----------
+// Masses, shapes and settings are left out: a step never changes them.
+uint64_t PhysicsWorld::getStateHash() const
+{
+    const size_t n = bodies.size();
+    uint64_t h = hashBytes(bodies.position.data(), n * sizeof(Vec2));
+    h = hashBytes(bodies.velocity.data(), n * sizeof(Vec2), h);
+    h = hashBytes(bodies.rotation.data(), n * sizeof(float), h);
+    h = hashBytes(bodies.angularVelocity.data(), n * sizeof(float), h);
+    h = hashBytes(bodies.awake.data(), n * sizeof(uint8_t), h);
+    return hashBytes(bodies.sleepTime.data(), n * sizeof(float), h);
+}
 
-    // -------- POSITION CORRECTION --------
-    float correctionMag =
-        std::max(penetration - penetrationSlop, 0.f) /
-        totalInvMass * penetrationPercent;
+// ---------- SNAPSHOTS ----------
+// Tags the start of every snapshot; bump the version whenever the list
+// of saved arrays changes.
+static constexpr uint32_t SNAPSHOT_MAGIC   = 0x50485953; // "PHYS"
+static constexpr uint32_t SNAPSHOT_VERSION = 2;
 
-    Vec2 correction = normal * correctionMag;
-    A.body->position -= correction * invMassA;
-    B.body->position += correction * invMassB;
+// Sweep and prune and the spatial grid are left out: they only speed
+// up finding the same pairs and put themselves right on the next step.
+void PhysicsWorld::saveSnapshot(WorldSnapshot& snapshot) const
+{
+    SnapshotWriter out(snapshot);
+    out.write(SNAPSHOT_MAGIC);
+    out.write(SNAPSHOT_VERSION);
+
+    out.write(stepCount);
+    out.write(accumulator);
+    out.write(boundsStale);
+    out.write(treeDirty);
+
+    bodies.save(out);
+    out.write(bounds);
+    tree.save(out);
+    contactCache.save(out);
 }
 
+bool PhysicsWorld::restoreSnapshot(const WorldSnapshot& snapshot)
+{
+    SnapshotReader in(snapshot);
+    uint32_t magic = 0, version = 0;
+    if (!in.read(magic) || !in.read(version) ||
+        magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+        return false;
+
+    uint32_t savedStepCount = 0;
+    float savedAccumulator = 0.f;
+    bool savedBoundsStale = true;
+    bool savedTreeDirty = true;
+    in.read(savedStepCount);
+    in.read(savedAccumulator);
+    in.read(savedBoundsStale);
+    in.read(savedTreeDirty);
+
+    restoredBodies.restore(in);
+    in.read(restoredBounds);
+    restoredTree.restore(in);
+    restoredCache.restore(in);
+    if (!in.ok()) return false;
+
+    stepCount = savedStepCount;
+    accumulator = savedAccumulator;
+    boundsStale = savedBoundsStale;
+    treeDirty = savedTreeDirty;
+
+    std::swap(bodies, restoredBodies);
+    bounds.swap(restoredBounds);
+    std::swap(tree, restoredTree);
+    std::swap(contactCache, restoredCache);
+
+    awakeRangesDirty = true;
+    return true;
+}
 
-void PhysicsWorld::resolveCircleVsBox(
-    PhysicsObject& circleObj,
-    PhysicsObject& boxObj)
+// Last step's transient arrays are dropped wholesale; the arrays the
+// accessors read are emptied right away so nothing sees stale memory.
+void PhysicsWorld::beginFrame()
 {
-    auto* cC = static_cast<CircleCollider*>(circleObj.collider);
-    auto* cB = static_cast<BoxCollider*>(boxObj.collider);
+    frameArena.reset();
+    for (auto& arena : threadArenas)
+        arena->reset();
+
+    pairs.clear();
+    contacts.clear();
+    islandContacts.clear();
+    pairRangeOutputs.clear();
+    sweptBodies.clear();
+    pseudoVelocity.clear();
+    coloredRun = nullptr;
+    for (auto& buffer : threadContacts)
+        buffer.clear();
+}
 
-    Vec2 cPos = circleObj.body->position;
-    Vec2 bPos = boxObj.body->position;
+void PhysicsWorld::updateAwakeRanges()
+{
+    if (awakeRangesDirty) {
+        buildAwakeRanges(bodies, awakeRanges);
+        awakeRangesDirty = false;
+    }
+}
 
-    float left   = bPos.x - cB->halfWidth;
-    float right  = bPos.x + cB->halfWidth;
-    float top    = bPos.y - cB->halfHeight;
-    float bottom = bPos.y + cB->halfHeight;
+void PhysicsWorld::integrateVelocities(float dt, const Vec2& acceleration)
+{
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Integrate);
+    updateAwakeRanges();
+    ::integrateVelocities(bodies, awakeRanges.data(), awakeRanges.size(), acceleration, dt);
+}
 
-    float closestX = clamp(cPos.x, left, right);
-    float closestY = clamp(cPos.y, top, bottom);
+// Bodies woken by a contact this step move too.
+void PhysicsWorld::integratePositions(float dt)
+{
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Integrate);
+    updateAwakeRanges();
+    ::integratePositions(bodies, awakeRanges.data(), awakeRanges.size(), dt);
+}
 
-    Vec2 closest{ closestX, closestY };
-    Vec2 delta = cPos - closest;
-    float dist = delta.magnitude();
+// Only awake bodies move, so static and sleeping bounds are kept
+// from the last full refresh or from when the body fell asleep.
+void PhysicsWorld::updateBounds()
+{
+    const size_t n = bodies.size();
+    bool full = boundsStale || bounds.size() != n;
+
+    bounds.resize(n);
+    for (uint32_t i = 0; i < n; i++)
+        if (full || bodies.awake[i])
+            bounds[i] = computeBounds(i);
+    boundsStale = false;
+}
 
-    Vec2 normal;
-    float penetration;
+AABB PhysicsWorld::computeBounds(uint32_t i) const
+{
+    if (bodies.type[i] == ColliderType::Circle)
+        return computeAABB(bodies.position[i], bodies.halfExtents[i]);
 
-    if (dist > 1e-6f) {
-        normal = delta / dist;
-        penetration = cC->radius - dist;
-    } else {
-        float dxL = cPos.x - left;
-        float dxR = right - cPos.x;
-        float dyT = cPos.y - top;
-        float dyB = bottom - cPos.y;
+    const Polygon& polygon = bodies.polygons[bodies.polygon[i]];
+    return computePolygonAABB(polygon, Transform(bodies.position[i], bodies.rotation[i]));
+}
 
-        float minX = std::min(dxL, dxR);
-        float minY = std::min(dyT, dyB);
+void PhysicsWorld::syncTree()
+{
+    for (uint32_t i = 0; i < bodies.size(); i++) {
+        int32_t& proxyId = bodies.proxyId[i];
+        if (proxyId == DynamicTree::NULL_NODE)
+            proxyId = tree.createProxy(bounds[i], i);
+        else
+            tree.moveProxy(proxyId, bounds[i]);
+    }
+    treeDirty = false;
+}
 
-        if (minX < minY) {
-            normal = (dxL < dxR) ? Vec2{-1,0} : Vec2{1,0};
-            penetration = cC->radius + minX;
-        } else {
-            normal = (dyT < dyB) ? Vec2{0,-1} : Vec2{0,1};
-            penetration = cC->radius + minY;
+void PhysicsWorld::findPairs()
+{
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Broadphase);
+    pairs.clear();
+    updateBounds();
+
+    switch (broadphase) {
+    case BroadphaseType::BruteForce: {
+        const uint32_t n = static_cast<uint32_t>(bodies.size());
+        for (uint32_t i = 0; i < n; i++)
+            for (uint32_t j = i + 1; j < n; j++)
+                if (bounds[i].overlaps(bounds[j]))
+                    pairs.push_back({ i, j });
+        break;
+    }
+    case BroadphaseType::SweepAndPrune:
+        sweepAndPrune.findPairs(bounds, pairs);
+        break;
+    case BroadphaseType::SpatialHashGrid:
+        spatialGrid.findPairs(bounds, gridCellSize, pairs);
+        break;
+    case BroadphaseType::DynamicTree:
+        syncTree();
+        // only awake bodies go looking for partners
+        for (uint32_t i = 0; i < bodies.size(); i++) {
+            if (!bodies.awake[i]) continue;
+
+            tree.query(bounds[i], [&](int32_t proxyId) {
+                uint32_t j = tree.getUserData(proxyId);
+                if ((j > i || !bodies.awake[j]) && bounds[i].overlaps(bounds[j]))
+                    pairs.push_back({ std::min(i, j), std::max(i, j) });
+                return true;
+            });
         }
+        break;
+    default:
+        break;
+    }
+
+    // Resolve in the same i<j order as the all-pairs loop; the solver is
+    // order sensitive and this keeps every broadphase behaving the same.
+    std::sort(pairs.begin(), pairs.end(),
+        [](const BroadphasePair& x, const BroadphasePair& y) {
+            return x.a != y.a ? x.a < y.a : x.b < y.b;
+        });
+}
+
+void PhysicsWorld::prepareQueries()
+{
+    if (treeDirty) {
+        updateBounds();
+        syncTree();
     }
+}
+
+// Closest shape along the segment, for a ray (radius 0) or a swept
+// circle. Only reads the world, so batches run it on several threads.
+bool PhysicsWorld::castClosest(const Vec2& from, const Vec2& to, float radius,
+    std::vector<int32_t>& stack, RaycastHit& hit) const
+{
+    hit = RaycastHit{};
+
+    tree.raycast(from, to, radius, stack,
+        [&](int32_t proxyId, const Vec2& p1, const Vec2& p2, float maxFraction) {
+            uint32_t i = tree.getUserData(proxyId);
+
+            float fraction;
+            Vec2 normal;
+            bool hitShape;
+            if (bodies.type[i] == ColliderType::Circle) {
+                hitShape = raycastCircle(p1, p2, maxFraction, bodies.position[i],
+                    bodies.halfExtents[i].x + radius, fraction, normal);
+            } else {
+                const Polygon& polygon = bodies.polygons[bodies.polygon[i]];
+                Transform xf(bodies.position[i], bodies.rotation[i]);
+                hitShape = (radius > 0.f)
+                    ? sweepCirclePolygon(p1, p2, radius, maxFraction, polygon, xf, fraction, normal)
+                    : raycastPolygon(p1, p2, maxFraction, polygon, xf, fraction, normal);
+            }
+
+            if (!hitShape) return maxFraction;
+
+            hit.body = bodies.handleOf(i);
+            hit.fraction = fraction;
+            hit.normal = normal;
+            return fraction;
+        });
 
-    if (penetration <= 0.f) return;
+    if (!hit.body.isValid()) return false;
+
+    hit.point = from + (to - from) * hit.fraction - hit.normal * radius;
+    return true;
+}
+
+bool PhysicsWorld::raycast(const Vec2& from, const Vec2& to, RaycastHit& hit)
+{
+    prepareQueries();
+    queryStacks.resize(std::max<size_t>(queryStacks.size(), 1));
+    return castClosest(from, to, 0.f, queryStacks[0], hit);
+}
+
+bool PhysicsWorld::castCircle(const Vec2& from, const Vec2& to, float radius, RaycastHit& hit)
+{
+    prepareQueries();
+    queryStacks.resize(std::max<size_t>(queryStacks.size(), 1));
+    return castClosest(from, to, radius, queryStacks[0], hit);
+}
+
+// Rays only read the world, so ranges of them go to the task pool like
+// the narrowphase's pair ranges; each thread walks the tree with its
+// own stack and writes only its own rays' hits.
+void PhysicsWorld::raycastBatch(const Ray* rays, size_t count, RaycastHit* hits)
+{
+    prepareQueries();
+
+    const uint32_t threads = static_cast<uint32_t>(std::max(threadCount, 1));
+    taskPool.setThreadCount(threads);
+    if (queryStacks.size() < threads) queryStacks.resize(threads);
+
+    constexpr uint32_t RAYS_PER_RANGE = 64;
+    taskPool.parallelFor(static_cast<uint32_t>(count), RAYS_PER_RANGE,
+        [&](uint32_t begin, uint32_t end, uint32_t thread) {
+            std::vector<int32_t>& stack = queryStacks[thread];
+            for (uint32_t k = begin; k < end; k++)
+                castClosest(rays[k].from, rays[k].to, 0.f, stack, hits[k]);
+        });
+}
 
-    Vec2 contactPoint = closest;
+void PhysicsWorld::queryAABB(const AABB& box, std::vector<BodyHandle>& results)
+{
+    prepareQueries();
+
+    results.clear();
+    tree.query(box, [&](int32_t proxyId) {
+        uint32_t i = tree.getUserData(proxyId);
+        if (bounds[i].overlaps(box))
+            results.push_back(bodies.handleOf(i));
+        return true;
+    });
+}
 
-    float invMassC = circleObj.body->invMass;
-    float invMassB = boxObj.body->invMass;
-    float totalInvMass = invMassC + invMassB;
-    if (totalInvMass == 0.f) return;
+void PhysicsWorld::queryPoint(const Vec2& point, std::vector<BodyHandle>& results)
+{
+    prepareQueries();
+
+    results.clear();
+    tree.query(AABB{ point, point }, [&](int32_t proxyId) {
+        uint32_t i = tree.getUserData(proxyId);
+        if (!bounds[i].overlaps(AABB{ point, point })) return true;
+
+        bool inside = (bodies.type[i] == ColliderType::Circle)
+            ? (point - bodies.position[i]).magnitudeSquared() <=
+                bodies.halfExtents[i].x * bodies.halfExtents[i].x
+            : testPointPolygon(point, bodies.polygons[bodies.polygon[i]],
+                Transform(bodies.position[i], bodies.rotation[i]));
+        if (inside)
+            results.push_back(bodies.handleOf(i));
+        return true;
+    });
+}
 
-    // ---------- RELATIVE VELOCITY (WITH ROTATION) ----------
-    Vec2 rC = contactPoint - circleObj.body->position;
-    Vec2 velC = circleObj.body->velocity +
-                perp(rC) * circleObj.body->angularVelocity;
-    Vec2 velB = boxObj.body->velocity;
+void PhysicsWorld::generateContacts()
+{
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Narrowphase);
+    contacts.clear();
+    threadScratch.resize(std::max(threadCount, 1));
 
-    Vec2 rv = velC - velB;
-    float vn = rv.dot(normal);
+    // pairs with nothing awake (sleeping or static) are dropped here
+    pairBuckets.build(frameArena, bodies, pairs);
 
-    // ---------- NORMAL IMPULSE ----------
-    float j = 0.f;
-    if (vn < 0.f) {
-        float restitution = std::min(cC->restitution, cB->restitution);
-        if (std::abs(vn) < 0.3f) restitution = 0.f;
+    if (threadCount > 1 && pairBuckets.size() >= MIN_PARALLEL_PAIRS)
+        generateContactsParallel();
+    else
+        collideBuckets(bodies, restingSpeed, pairBuckets, 0, pairBuckets.size(),
+            contacts, threadScratch[0]);
 
-        j = -(1.f + restitution) * vn / totalInvMass;
+    attachManifolds();
+}
 
-        Vec2 impulse = normal * j;
-        circleObj.body->velocity += impulse * invMassC;
-        boxObj.body->velocity    -= impulse * invMassB;
+// Pair tests only read body state, so ranges of the bucketed pair list
+// are handed to the task pool and each thread writes into its own
+// buffer. The buffers are then stitched back together in pair-range
+// order, which gives the same contact array as the serial loop no
+// matter which thread ran which range.
+void PhysicsWorld::generateContactsParallel()
+{
+    taskPool.setThreadCount(static_cast<uint32_t>(threadCount));
+
+    const uint32_t threads = taskPool.getThreadCount();
+    const uint32_t pairCount = pairBuckets.size();
+    const uint32_t grain = std::max(MIN_PAIR_GRAIN, pairCount / (threads * 8));
+    const uint32_t rangeCount = (pairCount + grain - 1) / grain;
+
+    while (threadArenas.size() < threads)
+        threadArenas.push_back(std::make_unique<FrameArena>());
+    if (threadContacts.size() != threads) {
+        threadContacts.resize(threads);
+        for (uint32_t t = 0; t < threads; t++)
+            threadContacts[t].bind(*threadArenas[t]);
+    }
+    for (auto& buffer : threadContacts)
+        buffer.clear();
+    threadScratch.resize(threads);
+    pairRangeOutputs.resize(rangeCount);
+
+    taskPool.parallelFor(pairCount, grain, [&](uint32_t begin, uint32_t end, uint32_t thread) {
+        FrameVector<Contact>& out = threadContacts[thread];
+        PairRangeOutput& range = pairRangeOutputs[begin / grain];
+        range.thread = thread;
+        range.begin = static_cast<uint32_t>(out.size());
+        collideBuckets(bodies, restingSpeed, pairBuckets, begin, end, out, threadScratch[thread]);
+        range.end = static_cast<uint32_t>(out.size());
+    });
+
+    // ---------- MERGE ----------
+    size_t total = 0;
+    for (const auto& buffer : threadContacts)
+        total += buffer.size();
+    contacts.resize(total);
+
+    size_t offset = 0;
+    for (const auto& range : pairRangeOutputs) {
+        const Contact* first = threadContacts[range.thread].data();
+        std::copy(first + range.begin, first + range.end, contacts.begin() + offset);
+        offset += range.end - range.begin;
     }
+}
 
-    // ---------- FRICTION ----------
-    Vec2 velC2 = circleObj.body->velocity +
-                 perp(rC) * circleObj.body->angularVelocity;
-    Vec2 rv2 = velC2 - velB;
-    float vn2 = rv2.dot(normal);
+// Serial pass over the merged contacts: wakes sleeping bodies that
+// were touched and pulls in the impulses carried over from the
+// previous step. A pair's points are contiguous and arrive in order,
+// so the manifold is re-keyed when its first point comes through and
+// every point picks up the old impulse with the same feature id.
+void PhysicsWorld::attachManifolds()
+{
+    ContactManifold previous;
+
+    for (size_t ci = 0; ci < contacts.size(); ci++) {
+        Contact& c = contacts[ci];
+        if (!bodies.awake[c.a]) wakeBody(c.a);
+        if (!bodies.awake[c.b]) wakeBody(c.b);
+
+        if (c.point == 0) {
+            c.manifold = contactCache.find(bodies.slot[c.a], bodies.slot[c.b]);
+            ContactManifold& m = contactCache[c.manifold];
+            previous = m;
+
+            m.stamp = stepCount;
+            m.pointCount = 0;
+            for (int k = 0; k < ContactManifold::MAX_POINTS; k++) {
+                m.normalImpulse[k] = 0.f;
+                m.tangentImpulse[k] = 0.f;
+            }
+        } else {
+            c.manifold = contacts[ci - 1].manifold;
+        }
 
-    Vec2 tangent = rv2 - normal * vn2;
-    float tMag = tangent.magnitude();
+        ContactManifold& m = contactCache[c.manifold];
+        m.id[c.point] = c.id;
+        m.pointCount = c.point + 1;
 
-    if (tMag > 1e-4f) {
-        tangent /= tMag;
+        if (!warmStarting) continue;
+        for (int k = 0; k < previous.pointCount; k++) {
+            if (previous.id[k] == c.id) {
+                c.normalImpulse = previous.normalImpulse[k];
+                c.tangentImpulse = previous.tangentImpulse[k];
+                break;
+            }
+        }
+    }
+}
 
-        float jt = -rv2.dot(tangent) / totalInvMass;
+// Lays the contact array out island by island, so island k is the
+// contiguous run [contactStart[k], contactStart[k + 1]). Contacts keep
+// their relative order inside an island.
+void PhysicsWorld::buildIslands()
+{
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Islands);
+    islandBuilder.build(bodies, contacts, islands);
+
+    islandContacts.clear();
+    islandContacts.reserve(contacts.size());
+    for (uint32_t ci : islands.contacts)
+        islandContacts.push_back(contacts[ci]);
+    contacts.swap(islandContacts);
+}
 
-        float muS = std::sqrt(
-            cC->staticFriction*cC->staticFriction +
-            cB->staticFriction*cB->staticFriction);
-        float muD = std::sqrt(
-            cC->dynamicFriction*cC->dynamicFriction +
-            cB->dynamicFriction*cB->dynamicFriction);
+// Islands share no dynamic body, so solving them one after another or
+// on separate threads gives bit-identical results. Positions are
+// integrated between the velocity and position phases, and fast
+// circles are swept once everything has settled.
+void PhysicsWorld::solveIslands(float dt)
+{
+    taskPool.setThreadCount(static_cast<uint32_t>(std::max(threadCount, 1)));
 
-        Vec2 frictionImpulse;
-        if (std::abs(jt) < j * muS)
-            frictionImpulse = tangent * jt;
-        else
-            frictionImpulse = tangent * -j * muD;
+    if (solver == SolverType::Substeps) {
+        solveSubsteps(dt);
+        return;
+    }
 
-        circleObj.body->velocity += frictionImpulse * invMassC;
-        boxObj.body->velocity    -= frictionImpulse * invMassB;
+    solveIslandPhase(SolverPhase::Velocity);
+    findSweptBodies(dt);
+    integratePositions(dt);
+    correctPositions(dt);
+    solveContinuous(dt);
+}
 
-        // 🔥 TORQUE FROM FRICTION
-        float torque = cross(rC, frictionImpulse);
-        circleObj.body->angularVelocity +=
-            torque * circleObj.body->invInertia;
+void PhysicsWorld::correctPositions(float dt)
+{
+    if (positionCorrection == PositionCorrection::Baumgarte) {
+        solveIslandPhase(SolverPhase::Position);
+        return;
     }
 
-    // ---------- POSITION CORRECTION ----------
-    float correctionMag =
-        std::max(penetration - penetrationSlop, 0.f) /
-        totalInvMass * penetrationPercent;
+    pseudoVelocity.resize(bodies.size());
+    std::fill(pseudoVelocity.begin(), pseudoVelocity.end(), Vec2{});
+    pseudoInvDt = 1.f / dt;
+
+    solveIslandPhase(SolverPhase::SplitImpulse);
+
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::PositionCorrection);
+    ::integratePseudoVelocities(bodies, pseudoVelocity.data(),
+        awakeRanges.data(), awakeRanges.size(), dt);
+}
 
-    Vec2 correction = normal * correctionMag;
-    circleObj.body->position += correction * invMassC;
-    boxObj.body->position    -= correction * invMassB;
+// TGS-style: the contacts found at the start of the step are reused by
+// every substep, with their penetration tracked from how far the
+// bodies have moved since. Impulses accumulate per substep, so the warm
+// start carries between substeps as well as between steps. Circles to
+// sweep are picked up front, from the velocities the step starts with.
+void PhysicsWorld::solveSubsteps(float dt)
+{
+    const int count = std::max(substeps, 1);
+    const float h = dt / static_cast<float>(count);
+    // stiffer than a quarter of the substep rate rings instead of settling
+    const float hertz = std::min(contactHertz, 0.25f / h);
+    softness = makeContactSoftness(hertz, contactDampingRatio, h);
+
+    findSweptBodies(dt);
+    for (int k = 0; k < count; k++) {
+        integrateVelocities(h, gravity);
+        solveIslandPhase(SolverPhase::Substep);
+        integratePositions(h);
+        solveIslandPhase(SolverPhase::Relax);
+    }
+    solveContinuous(dt);
 }
 
+void PhysicsWorld::solveIslandPhase(SolverPhase phase)
+{
+    PHYSICS_PROFILE_SCOPE(phase == SolverPhase::Position || phase == SolverPhase::SplitImpulse
+        ? ProfilePhase::PositionCorrection
+        : ProfilePhase::Solve);
+
+    const uint32_t islandCount = static_cast<uint32_t>(islands.count());
+    auto islandRun = [this](uint32_t k) {
+        return std::make_pair(contacts.data() + islands.contactStart[k],
+            size_t(islands.contactStart[k + 1] - islands.contactStart[k]));
+    };
+
+    // several ranges per thread leaves room for stealing when one
+    // island is much bigger than the rest
+    uint32_t grain = std::max(1u, islandCount / (taskPool.getThreadCount() * 4));
+
+    taskPool.parallelFor(islandCount, grain, [&](uint32_t begin, uint32_t end, uint32_t) {
+        for (uint32_t k = begin; k < end; k++) {
+            auto [run, count] = islandRun(k);
+            if (!isColoredIsland(count))
+                solveIsland(run, count, phase);
+        }
+    });
 
+    // big islands get every thread, one at a time
+    for (uint32_t k = 0; k < islandCount; k++) {
+        auto [run, count] = islandRun(k);
+        if (isColoredIsland(count))
+            solveColoredIsland(run, count, phase);
+    }
+}
 
-void PhysicsWorld::resolveAABBvsAABB(
-    PhysicsObject& A,
-    PhysicsObject& B)
+bool PhysicsWorld::isColoredIsland(size_t count) const
 {
-    auto* cA = static_cast<BoxCollider*>(A.collider);
-    auto* cB = static_cast<BoxCollider*>(B.collider);
+    return graphColoring && count >= MIN_COLORED_ISLAND_CONTACTS;
+}
 
-    Vec2 posA = A.body->position;
-    Vec2 posB = B.body->position;
+void PhysicsWorld::solveIsland(Contact* run, size_t count, SolverPhase phase)
+{
+    if (count == 0) return;
+
+    switch (phase) {
+    case SolverPhase::Velocity:
+        if (warmStarting)
+            warmStartContacts(bodies, run, count);
+        for (int k = 0; k < solverIterations; k++)
+            solveVelocityConstraints(bodies, run, count);
+        break;
+    case SolverPhase::Position:
+        for (int k = 0; k < positionIterations; k++)
+            solvePositionConstraints(bodies, run, count,
+                penetrationPercent, penetrationSlop);
+        break;
+    case SolverPhase::SplitImpulse:
+        for (int k = 0; k < positionIterations; k++)
+            solvePseudoVelocityConstraints(bodies, pseudoVelocity.data(), run, count,
+                penetrationPercent, penetrationSlop, pseudoInvDt);
+        break;
+    case SolverPhase::Substep:
+        if (warmStarting)
+            warmStartContacts(bodies, run, count);
+        solveSoftVelocityConstraints(bodies, run, count, softness, penetrationSlop, true);
+        break;
+    case SolverPhase::Relax:
+        solveSoftVelocityConstraints(bodies, run, count, softness, penetrationSlop, false);
+        break;
+    }
+}
 
-    float dx = posB.x - posA.x;
-    float px = (cA->halfWidth + cB->halfWidth) - std::abs(dx);
-    if (px <= 0.f) return;
+// Same passes as solveIsland, but colour by colour: a colour's contacts
+// share no dynamic body and are spread over the task pool. The
+// colouring is shared by all big islands, so it is rebuilt whenever
+// another island comes through; colouring a run again gives the same
+// order, so with one big island it is built once per step.
+void PhysicsWorld::solveColoredIsland(Contact* run, size_t count, SolverPhase phase)
+{
+    if (run != coloredRun || count != coloredCount) {
+        coloring.build(bodies, run, count);
+        coloredRun = run;
+        coloredCount = count;
+    }
 
-    float dy = posB.y - posA.y;
-    float py = (cA->halfHeight + cB->halfHeight) - std::abs(dy);
-    if (py <= 0.f) return;
+    const uint32_t threads = taskPool.getThreadCount();
 
-    Vec2 normal;
-    float penetration;
+    auto forEachColor = [&](auto&& kernel) {
+        for (uint32_t color = 0; color < coloring.getColorCount(); color++) {
+            uint32_t first = coloring.getColorBegin(color);
+            uint32_t size  = coloring.getColorEnd(color) - first;
 
-    if (px < py) {
-        normal = { (dx < 0.f) ? -1.f : 1.f, 0.f };
-        penetration = px;
-    } else {
-        normal = { 0.f, (dy < 0.f) ? -1.f : 1.f };
-        penetration = py;
+            if (coloring.isOverflow(color)) {
+                kernel(run + first, size);
+                continue;
+            }
+
+            // a range never splits a manifold: one starting on a second
+            // point leaves it to the range before, which takes one past
+            // its end instead
+            const Contact* colorRun = run + first;
+            uint32_t grain = std::max(MIN_COLOR_GRAIN, size / (threads * 4));
+            taskPool.parallelFor(size, grain, [&](uint32_t begin, uint32_t end, uint32_t) {
+                if (ContactColoring::isSecondPoint(colorRun, begin)) begin++;
+                if (end < size && ContactColoring::isSecondPoint(colorRun, end)) end++;
+                kernel(run + first + begin, end - begin);
+            });
+        }
+    };
+
+    switch (phase) {
+    case SolverPhase::Velocity:
+        if (warmStarting)
+            forEachColor([&](Contact* c, size_t n) { warmStartContacts(bodies, c, n); });
+        for (int k = 0; k < solverIterations; k++)
+            forEachColor([&](Contact* c, size_t n) { solveVelocityConstraints(bodies, c, n); });
+        break;
+    case SolverPhase::Position:
+        for (int k = 0; k < positionIterations; k++)
+            forEachColor([&](Contact* c, size_t n) {
+                solvePositionConstraints(bodies, c, n, penetrationPercent, penetrationSlop);
+            });
+        break;
+    case SolverPhase::SplitImpulse:
+        for (int k = 0; k < positionIterations; k++)
+            forEachColor([&](Contact* c, size_t n) {
+                solvePseudoVelocityConstraints(bodies, pseudoVelocity.data(), c, n,
+                    penetrationPercent, penetrationSlop, pseudoInvDt);
+            });
+        break;
+    case SolverPhase::Substep:
+        if (warmStarting)
+            forEachColor([&](Contact* c, size_t n) { warmStartContacts(bodies, c, n); });
+        forEachColor([&](Contact* c, size_t n) {
+            solveSoftVelocityConstraints(bodies, c, n, softness, penetrationSlop, true);
+        });
+        break;
+    case SolverPhase::Relax:
+        forEachColor([&](Contact* c, size_t n) {
+            solveSoftVelocityConstraints(bodies, c, n, softness, penetrationSlop, false);
+        });
+        break;
     }
+}
 
-    float invMassA = A.body->invMass;
-    float invMassB = B.body->invMass;
-    float totalInvMass = invMassA + invMassB;
-    if (totalInvMass == 0.f) return;
+void PhysicsWorld::storeImpulses()
+{
+    for (const auto& c : contacts) {
+        ContactManifold& m = contactCache[c.manifold];
+        m.normalImpulse[c.point] = c.normalImpulse;
+        m.tangentImpulse[c.point] = c.tangentImpulse;
+    }
+}
 
-    // ---------- NORMAL IMPULSE ----------
-    Vec2 rv = B.body->velocity - A.body->velocity;
-    float vn = rv.dot(normal);
+// ---------- CONTINUOUS COLLISION ----------
+// Picks the circles to sweep, with their solved velocities and before
+// they move.
+void PhysicsWorld::findSweptBodies(float dt)
+{
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Continuous);
+    sweptBodies.clear();
+    if (!continuousCollision) return;
 
-    float j = 0.f;
-    if (vn < 0.f) {
-        float restitution = std::min(cA->restitution, cB->restitution);
-        if (std::abs(vn) < 0.3f) restitution = 0.f;
+    updateAwakeRanges(); // contacts may have woken bodies
 
-        j = -(1.f + restitution) * vn / totalInvMass;
+    for (const BodyRange& range : awakeRanges) {
+        for (uint32_t i = range.begin; i < range.end; i++) {
+            if (bodies.type[i] != ColliderType::Circle) continue;
 
-        Vec2 impulse = normal * j;
-        A.body->velocity -= impulse * invMassA;
-        B.body->velocity += impulse * invMassB;
+            float reach = ccdMotionThreshold * bodies.halfExtents[i].x;
+            float travel = bodies.velocity[i].magnitude() * dt;
+            if (bodies.bullet[i] || travel > reach)
+                sweptBodies.push_back({ i, bodies.position[i] });
+        }
     }
+}
 
-    // ---------- FRICTION ----------
-    rv = B.body->velocity - A.body->velocity;
-    float vn2 = rv.dot(normal);
+// Serial, in body order. Other bodies are taken where they ended the
+// step; shapes a circle already touches where it started are ignored,
+// so resting contacts stay with the discrete solver.
+void PhysicsWorld::solveContinuous(float dt)
+{
+    if (sweptBodies.empty()) return;
+
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Continuous);
+    updateBounds();
+    syncTree();
+
+    for (const SweptBody& swept : sweptBodies) {
+        const uint32_t i = swept.body;
+        Vec2 from = swept.start;
+        Vec2 to = bodies.position[i];
+        float remaining = dt;
+
+        for (int k = 0; k < maxCcdSubsteps; k++) {
+            float fraction;
+            Vec2 normal;
+            uint32_t other;
+            if (!sweepBody(i, from, to, fraction, normal, other)) break;
+
+            // stop at the impact, bounce, and move on with what is left
+            from = from + (to - from) * fraction;
+            remaining *= 1.f - fraction;
+            bodies.position[i] = from;
+            resolveImpact(i, other, normal);
+            to = (k + 1 < maxCcdSubsteps)
+                ? from + bodies.velocity[i] * remaining
+                : from;
+        }
 
-    Vec2 tangent = rv - normal * vn2;
-    float tMag = tangent.magnitude();
+        bodies.position[i] = to;
+    }
 
-    const float TANGENT_EPS = 1e-4f;
-    if (tMag > TANGENT_EPS) {
-        tangent /= tMag;
+    boundsStale = true;
+}
 
-        float jt = -rv.dot(tangent) / totalInvMass;
+// Earliest impact of circle i moving from -> to, against the other
+// bodies' tree leaves along the way. Only surfaces the circle moves
+// into count.
+bool PhysicsWorld::sweepBody(uint32_t i, const Vec2& from, const Vec2& to,
+    float& fraction, Vec2& normal, uint32_t& other)
+{
+    const float radius = bodies.halfExtents[i].x;
+    const Vec2 motion = to - from;
+
+    const AABB swept = AABB::combine(
+        computeAABB(from, bodies.halfExtents[i]),
+        computeAABB(to, bodies.halfExtents[i]));
+
+    fraction = 1.f;
+    bool hit = false;
+
+    tree.query(swept, [&](int32_t proxyId) {
+        uint32_t j = tree.getUserData(proxyId);
+        if (j == i || !bounds[j].overlaps(swept)) return true;
+
+        float t;
+        Vec2 n;
+        bool hitShape = (bodies.type[j] == ColliderType::Circle)
+            ? raycastCircle(from, to, fraction, bodies.position[j],
+                radius + bodies.halfExtents[j].x, t, n)
+            : sweepCirclePolygon(from, to, radius, fraction, bodies.polygons[bodies.polygon[j]],
+                Transform(bodies.position[j], bodies.rotation[j]), t, n);
+
+        if (hitShape && n.dot(motion) < 0.f) {
+            fraction = t;
+            normal = n;
+            other = j;
+            hit = true;
+        }
+        return true;
+    });
 
-        float muS = std::sqrt(
-            cA->staticFriction * cA->staticFriction +
-            cB->staticFriction * cB->staticFriction);
+    return hit;
+}
 
-        float muD = std::sqrt(
-            cA->dynamicFriction * cA->dynamicFriction +
-            cB->dynamicFriction * cB->dynamicFriction);
+// Normal impulse at the time of impact, with the same restitution rule
+// as a discrete contact; friction is left to next step's contact.
+void PhysicsWorld::resolveImpact(uint32_t i, uint32_t other, const Vec2& normal)
+{
+    const Vec2 point = bodies.position[i] - normal * bodies.halfExtents[i].x;
+    const Vec2 rB = point - bodies.position[other];
+
+    Vec2 velocityB = bodies.velocity[other] + perp(rB) * bodies.angularVelocity[other];
+    float vn = (bodies.velocity[i] - velocityB).dot(normal);
+    if (vn >= 0.f) return;
+
+    float rnB = cross(rB, normal);
+    float k = bodies.invMass[i] + bodies.invMass[other] + bodies.invInertia[other] * rnB * rnB;
+
+    float restitution = (vn < -restingSpeed)
+        ? std::min(bodies.restitution[i], bodies.restitution[other])
+        : 0.f;
+    Vec2 impulse = normal * (-(1.f + restitution) * vn / k);
+
+    bodies.velocity[i] += impulse * bodies.invMass[i];
+    if (bodies.invMass[other] > 0.f) {
+        wakeBody(other);
+        bodies.velocity[other] -= impulse * bodies.invMass[other];
+        bodies.angularVelocity[other] -= cross(rB, impulse) * bodies.invInertia[other];
+    }
+}
 
-        Vec2 frictionImpulse;
-        if (std::abs(jt) < j * muS)
-            frictionImpulse = tangent * jt;
-        else
-            frictionImpulse = tangent * -j * muD;
+// ---------- SLEEP ----------
+// Bodies are grouped into contact islands; an island only sleeps once
+// every body in it has been slow for timeToSleep, so a resting stack
+// never has half its boxes frozen under a moving one.
+void PhysicsWorld::updateSleep(float dt)
+{
+    PHYSICS_PROFILE_SCOPE(ProfilePhase::Sleep);
+    const uint32_t n = static_cast<uint32_t>(bodies.size());
 
-        A.body->velocity -= frictionImpulse * invMassA;
-        B.body->velocity += frictionImpulse * invMassB;
+    if (!allowSleep) {
+        for (uint32_t i = 0; i < n; i++)
+            if (!bodies.awake[i]) wakeBody(i);
+        return;
     }
 
-    // ---------- POSITION CORRECTION (LAST) ----------
-    float correctionMag =
-        std::max(penetration - penetrationSlop, 0.f) /
-        totalInvMass * penetrationPercent;
+    const float linTolSq = sleepLinearTolerance * sleepLinearTolerance;
+
+    for (size_t k = 0; k < islands.count(); k++) {
+        float minSleepTime = timeToSleep;
+
+        for (uint32_t bi = islands.bodyStart[k]; bi < islands.bodyStart[k + 1]; bi++) {
+            uint32_t i = islands.bodies[bi];
 
-    Vec2 correction = normal * correctionMag;
-    A.body->position -= correction * invMassA;
-    B.body->position += correction * invMassB;
+            bool slow =
+                bodies.velocity[i].magnitudeSquared() <= linTolSq &&
+                std::abs(bodies.angularVelocity[i]) <= sleepAngularTolerance;
+
+            bodies.sleepTime[i] = slow ? bodies.sleepTime[i] + dt : 0.f;
+            minSleepTime = std::min(minSleepTime, bodies.sleepTime[i]);
+        }
+
+        if (minSleepTime < timeToSleep) continue;
+
+        // bounds were taken before this step's move, and updateBounds
+        // skips sleeping bodies from now on
+        awakeRangesDirty = true;
+        for (uint32_t bi = islands.bodyStart[k]; bi < islands.bodyStart[k + 1]; bi++) {
+            uint32_t i = islands.bodies[bi];
+            bounds[i] = computeBounds(i);
+            bodies.awake[i] = 0;
+            bodies.velocity[i] = {0, 0};
+            bodies.angularVelocity[i] = 0.f;
+            bodies.force[i] = {0, 0};
+        }
+    }
 }
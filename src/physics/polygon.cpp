@@ -0,0 +1,108 @@
+#include "physics/polygon.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
+
+static void computeNormals(Polygon& polygon)
+{
+    polygon.radius = 0.f;
+    for (int i = 0; i < polygon.count; i++) {
+        const Vec2& v1 = polygon.vertices[i];
+        const Vec2& v2 = polygon.vertices[(i + 1) % polygon.count];
+
+        // vertices wind with positive cross products, so the outward
+        // normal is the edge turned by -90 degrees
+        Vec2 edge = v2 - v1;
+        polygon.normals[i] = Vec2{ edge.y, -edge.x }.normalized();
+        polygon.radius = std::max(polygon.radius, v1.magnitude());
+    }
+}
+
+Polygon makeBox(float halfWidth, float halfHeight)
+{
+    Polygon box;
+    box.count = 4;
+    box.vertices[0] = { -halfWidth, -halfHeight };
+    box.vertices[1] = {  halfWidth, -halfHeight };
+    box.vertices[2] = {  halfWidth,  halfHeight };
+    box.vertices[3] = { -halfWidth,  halfHeight };
+    computeNormals(box);
+    return box;
+}
+
+bool makePolygon(const Vec2* points, int count, Polygon& polygon, Vec2& centroid)
+{
+    if (count < 3 || count > Polygon::MAX_VERTICES) return false;
+
+    // ---------- CONVEX HULL (monotone chain) ----------
+    Vec2 sorted[Polygon::MAX_VERTICES];
+    std::copy(points, points + count, sorted);
+    std::sort(sorted, sorted + count, [](const Vec2& a, const Vec2& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+
+    Vec2 hull[2 * Polygon::MAX_VERTICES];
+    int n = 0;
+    auto turn = [](const Vec2& o, const Vec2& a, const Vec2& b) {
+        return cross(a - o, b - o);
+    };
+    for (int i = 0; i < count; i++) {
+        while (n >= 2 && turn(hull[n - 2], hull[n - 1], sorted[i]) <= 0.f) n--;
+        hull[n++] = sorted[i];
+    }
+    for (int i = count - 2, lower = n + 1; i >= 0; i--) {
+        while (n >= lower && turn(hull[n - 2], hull[n - 1], sorted[i]) <= 0.f) n--;
+        hull[n++] = sorted[i];
+    }
+    n--; // last point repeats the first
+    if (n < 3) return false;
+
+    // ---------- CENTROID ----------
+    float area = 0.f;
+    Vec2 c{0.f, 0.f};
+    for (int i = 0; i < n; i++) {
+        const Vec2& a = hull[i];
+        const Vec2& b = hull[(i + 1) % n];
+        float triangle = 0.5f * cross(a, b);
+        area += triangle;
+        c += (a + b) * (triangle / 3.f);
+    }
+    if (std::abs(area) < 1e-6f) return false;
+    c /= area;
+
+    polygon.count = n;
+    for (int i = 0; i < n; i++)
+        polygon.vertices[i] = hull[i] - c;
+    computeNormals(polygon);
+
+    centroid = c;
+    return true;
+}
+
+float polygonInertia(const Polygon& polygon, float mass)
+{
+    // second moment of area, summed over the triangles fanning out of
+    // the centroid, scaled to the mass
+    float area = 0.f;
+    float moment = 0.f;
+    for (int i = 0; i < polygon.count; i++) {
+        const Vec2& a = polygon.vertices[i];
+        const Vec2& b = polygon.vertices[(i + 1) % polygon.count];
+        float d = cross(a, b);
+        area += 0.5f * d;
+        moment += d * (a.dot(a) + a.dot(b) + b.dot(b)) / 12.f;
+    }
+    return mass * moment / area;
+}
+
+AABB computePolygonAABB(const Polygon& polygon, const Transform& xf)
+{
+    Vec2 lo = xf.apply(polygon.vertices[0]);
+    Vec2 hi = lo;
+    for (int i = 1; i < polygon.count; i++) {
+        Vec2 v = xf.apply(polygon.vertices[i]);
+        lo = { std::min(lo.x, v.x), std::min(lo.y, v.y) };
+        hi = { std::max(hi.x, v.x), std::max(hi.y, v.y) };
+    }
+    return { lo, hi };
+}
@@ -0,0 +1,75 @@
+#include "physics/profile.h"
+#include <algorithm>
+
+const char* getProfilePhaseName(ProfilePhase phase)
+{
+    switch (phase) {
+        case ProfilePhase::Integrate:          return "integrate";
+        case ProfilePhase::Broadphase:         return "broadphase";
+        case ProfilePhase::Narrowphase:        return "narrowphase";
+        case ProfilePhase::Islands:            return "islands";
+        case ProfilePhase::Solve:              return "solve";
+        case ProfilePhase::PositionCorrection: return "position_correction";
+        case ProfilePhase::Continuous:         return "continuous";
+        case ProfilePhase::Sleep:              return "sleep";
+        default:                               return "unknown";
+    }
+}
+
+void ProfileHistory::setCapacity(size_t capacity)
+{
+    frames.assign(std::max<size_t>(capacity, 1), StepProfile{});
+    clear();
+}
+
+void ProfileHistory::push(const StepProfile& frame)
+{
+    frames[head] = frame;
+    head = (head + 1) % frames.size();
+    count = std::min(count + 1, frames.size());
+}
+
+const StepProfile& ProfileHistory::operator[](size_t i) const
+{
+    size_t oldest = (head + frames.size() - count) % frames.size();
+    return frames[(oldest + i) % frames.size()];
+}
+
+// ---------- DUMP ----------
+void ProfileHistory::writeJson(std::ostream& out) const
+{
+    out << "[\n";
+    for (size_t i = 0; i < count; i++) {
+        const StepProfile& f = (*this)[i];
+        out << "  {\"step\": " << f.step << ", \"total_ns\": " << f.totalNs;
+        for (uint32_t p = 0; p < PROFILE_PHASE_COUNT; p++)
+            out << ", \"" << getProfilePhaseName(static_cast<ProfilePhase>(p)) << "_ns\": " << f.phaseNs[p];
+        out << ", \"pairs\": " << f.pairs
+            << ", \"pairs_tested\": " << f.pairsTested
+            << ", \"contacts\": " << f.contacts
+            << ", \"active_bodies\": " << f.activeBodies
+            << ", \"islands\": " << f.islands
+            << ", \"swept_bodies\": " << f.sweptBodies
+            << ", \"frame_bytes\": " << f.frameBytes
+            << (i + 1 < count ? "},\n" : "}\n");
+    }
+    out << "]\n";
+}
+
+void ProfileHistory::writeCsv(std::ostream& out) const
+{
+    out << "step,total_ns";
+    for (uint32_t p = 0; p < PROFILE_PHASE_COUNT; p++)
+        out << ',' << getProfilePhaseName(static_cast<ProfilePhase>(p)) << "_ns";
+    out << ",pairs,pairs_tested,contacts,active_bodies,islands,swept_bodies,frame_bytes\n";
+
+    for (size_t i = 0; i < count; i++) {
+        const StepProfile& f = (*this)[i];
+        out << f.step << ',' << f.totalNs;
+        for (uint32_t p = 0; p < PROFILE_PHASE_COUNT; p++)
+            out << ',' << f.phaseNs[p];
+        out << ',' << f.pairs << ',' << f.pairsTested << ',' << f.contacts
+            << ',' << f.activeBodies << ',' << f.islands << ',' << f.sweptBodies
+            << ',' << f.frameBytes << '\n';
+    }
+}
@@ -0,0 +1,58 @@
+#include "physics/snapshot.h"
+
+SnapshotWriter::SnapshotWriter(WorldSnapshot& snapshot)
+    : snapshot(snapshot)
+{
+    snapshot.bytes.clear();
+}
+
+void SnapshotWriter::writeBytes(const void* source, size_t count)
+{
+    if (count == 0) return;
+
+    size_t offset = snapshot.bytes.size();
+    snapshot.bytes.resize(offset + count);
+    std::memcpy(snapshot.bytes.data() + offset, source, count);
+}
+
+SnapshotReader::SnapshotReader(const WorldSnapshot& snapshot)
+    : snapshot(snapshot)
+{
+}
+
+bool SnapshotReader::readBytes(void* target, size_t count)
+{
+    if (failed || count > remaining()) return fail();
+    if (count == 0) return true;
+
+    std::memcpy(target, snapshot.bytes.data() + offset, count);
+    offset += count;
+    return true;
+}
+
+// Eight bytes at a time through a multiply-xorshift mix, then the tail.
+uint64_t hashBytes(const void* data, size_t count, uint64_t seed)
+{
+    const uint64_t MUL = 0x9e3779b97f4a7c15ull;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    uint64_t h = seed ^ (count * MUL);
+    auto mix = [&](uint64_t word) {
+        h ^= word;
+        h *= MUL;
+        h ^= h >> 29;
+    };
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        mix(word);
+    }
+    if (i < count) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + i, count - i);
+        mix(word);
+    }
+    return h ^ (h >> 32);
+}
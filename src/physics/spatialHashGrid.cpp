@@ -0,0 +1,156 @@
+#include "physics/spatialHashGrid.h"
+#include <algorithm>
+#include <cmath>
+
+void SpatialHashGrid::clear()
+{
+    buckets.clear();
+    proxies.clear();
+    largeProxies.clear();
+}
+
+void SpatialHashGrid::removeProxy(uint32_t index)
+{
+    if (index >= proxies.size()) return; // not seen by findPairs yet
+
+    const uint32_t last = static_cast<uint32_t>(proxies.size() - 1);
+    if (proxies[index].inGrid)
+        remove(index, proxies[index].range);
+
+    if (index != last) {
+        const Proxy& moved = proxies[last];
+        if (moved.inGrid) {
+            const CellRange& r = moved.range;
+            for (int32_t y = r.minY; y <= r.maxY; y++)
+                for (int32_t x = r.minX; x <= r.maxX; x++)
+                    for (Entry& e : buckets[hashCell(x, y)])
+                        if (e.proxy == last && e.cellX == x && e.cellY == y)
+                            e.proxy = index;
+        }
+        proxies[index] = moved;
+    }
+    proxies.pop_back();
+}
+
+SpatialHashGrid::CellRange SpatialHashGrid::computeRange(const AABB& box) const
+{
+    float inv = 1.f / cellSize;
+    return {
+        static_cast<int32_t>(std::floor(box.min.x * inv)),
+        static_cast<int32_t>(std::floor(box.min.y * inv)),
+        static_cast<int32_t>(std::floor(box.max.x * inv)),
+        static_cast<int32_t>(std::floor(box.max.y * inv))
+    };
+}
+
+uint32_t SpatialHashGrid::hashCell(int32_t x, int32_t y)
+{
+    uint32_t h = static_cast<uint32_t>(x) * 73856093u ^
+                 static_cast<uint32_t>(y) * 19349663u;
+    return h & (BUCKET_COUNT - 1);
+}
+
+void SpatialHashGrid::insert(uint32_t proxy, const CellRange& range)
+{
+    for (int32_t y = range.minY; y <= range.maxY; y++)
+        for (int32_t x = range.minX; x <= range.maxX; x++)
+            buckets[hashCell(x, y)].push_back({ x, y, proxy });
+}
+
+void SpatialHashGrid::remove(uint32_t proxy, const CellRange& range)
+{
+    for (int32_t y = range.minY; y <= range.maxY; y++) {
+        for (int32_t x = range.minX; x <= range.maxX; x++) {
+            auto& bucket = buckets[hashCell(x, y)];
+            for (size_t k = 0; k < bucket.size(); k++) {
+                const Entry& e = bucket[k];
+                if (e.proxy == proxy && e.cellX == x && e.cellY == y) {
+                    bucket[k] = bucket.back();
+                    bucket.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::findPairs(
+    const std::vector<AABB>& bounds,
+    float newCellSize,
+    FrameVector<BroadphasePair>& pairs
+) {
+    pairs.clear();
+
+    // ---------- (RE)BUILD ON SETTINGS CHANGE ----------
+    if (newCellSize != cellSize || proxies.size() > bounds.size()) {
+        clear();
+        cellSize = newCellSize;
+    }
+    if (buckets.empty())
+        buckets.resize(BUCKET_COUNT);
+
+    proxies.resize(bounds.size());
+    largeProxies.clear();
+
+    // ---------- INCREMENTAL UPDATE ----------
+    for (uint32_t i = 0; i < bounds.size(); i++) {
+        Proxy& p = proxies[i];
+        CellRange range = computeRange(bounds[i]);
+
+        int64_t cells =
+            int64_t(range.maxX - range.minX + 1) *
+            int64_t(range.maxY - range.minY + 1);
+        p.large = cells > maxCellsPerProxy;
+
+        if (p.large) {
+            if (p.inGrid) remove(i, p.range);
+            p.inGrid = false;
+            largeProxies.push_back(i);
+        }
+        else if (!p.inGrid) {
+            insert(i, range);
+            p.inGrid = true;
+        }
+        else if (range != p.range) {
+            remove(i, p.range);
+            insert(i, range);
+        }
+        p.range = range;
+    }
+
+    // ---------- PAIRS INSIDE CELLS ----------
+    // A pair sharing several cells is only reported from the cell at
+    // the max of both ranges' minimum corner, so no dedup pass is needed.
+    for (const auto& bucket : buckets) {
+        for (size_t i = 0; i < bucket.size(); i++) {
+            const Entry& eA = bucket[i];
+
+            for (size_t j = i + 1; j < bucket.size(); j++) {
+                const Entry& eB = bucket[j];
+                if (eA.cellX != eB.cellX || eA.cellY != eB.cellY) continue;
+
+                const CellRange& rA = proxies[eA.proxy].range;
+                const CellRange& rB = proxies[eB.proxy].range;
+                if (eA.cellX != std::max(rA.minX, rB.minX)) continue;
+                if (eA.cellY != std::max(rA.minY, rB.minY)) continue;
+
+                if (!bounds[eA.proxy].overlaps(bounds[eB.proxy])) continue;
+
+                uint32_t a = std::min(eA.proxy, eB.proxy);
+                uint32_t b = std::max(eA.proxy, eB.proxy);
+                pairs.push_back({ a, b });
+            }
+        }
+    }
+
+    // ---------- LARGE PROXIES ----------
+    for (uint32_t L : largeProxies) {
+        for (uint32_t i = 0; i < bounds.size(); i++) {
+            if (i == L) continue;
+            if (proxies[i].large && i < L) continue; // reported from i
+
+            if (!bounds[L].overlaps(bounds[i])) continue;
+            pairs.push_back({ std::min(L, i), std::max(L, i) });
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#include "physics/taskPool.h"
+#include <algorithm>
+
+TaskPool::TaskPool(uint32_t threadCount)
+{
+    setThreadCount(threadCount);
+}
+
+TaskPool::~TaskPool()
+{
+    stopWorkers();
+}
+
+void TaskPool::setThreadCount(uint32_t count)
+{
+    count = std::max(count, 1u);
+    if (count == threadCount && queues) return;
+
+    stopWorkers();
+
+    threadCount = count;
+    queues = std::make_unique<Queue[]>(threadCount);
+
+    quit = false;
+    busyWorkers = 0;
+    workers.reserve(threadCount - 1);
+    for (uint32_t t = 1; t < threadCount; t++)
+        workers.emplace_back(&TaskPool::workerMain, this, t, generation);
+}
+
+void TaskPool::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wakeWorkers.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+void TaskPool::run(uint32_t count, uint32_t grain, Kernel fn, void* ctx)
+{
+    if (count == 0) return;
+    grain = std::max(grain, 1u);
+
+    const uint32_t rangeCount = (count + grain - 1) / grain;
+    if (threadCount == 1 || rangeCount == 1) {
+        fn(ctx, 0, count, 0);
+        return;
+    }
+
+    // ---------- DEAL RANGES ----------
+    // contiguous blocks per thread so each one starts on its own slice
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (uint32_t t = 0; t < threadCount; t++) {
+            Queue& q = queues[t];
+            q.ranges.clear();
+
+            uint32_t first = static_cast<uint32_t>(uint64_t(rangeCount) * t / threadCount);
+            uint32_t last  = static_cast<uint32_t>(uint64_t(rangeCount) * (t + 1) / threadCount);
+            for (uint32_t r = first; r < last; r++)
+                q.ranges.push_back({ r * grain, std::min(count, (r + 1) * grain) });
+
+            q.head = 0;
+            q.tail = static_cast<uint32_t>(q.ranges.size());
+        }
+
+        kernel = fn;
+        context = ctx;
+        busyWorkers = threadCount - 1;
+        generation++;
+    }
+    wakeWorkers.notify_all();
+
+    drain(0);
+
+    // every worker has to check in before the queues can be refilled
+    std::unique_lock<std::mutex> lock(mutex);
+    workersDone.wait(lock, [this] { return busyWorkers == 0; });
+}
+
+void TaskPool::workerMain(uint32_t thread, uint64_t seenGeneration)
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorkers.wait(lock, [&] { return quit || generation != seenGeneration; });
+            if (quit) return;
+            seenGeneration = generation;
+        }
+
+        drain(thread);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyWorkers == 0)
+                workersDone.notify_one();
+        }
+    }
+}
+
+bool TaskPool::popRange(uint32_t thread, Range& range)
+{
+    {
+        Queue& own = queues[thread];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.head < own.tail) {
+            range = own.ranges[own.head++];
+            return true;
+        }
+    }
+
+    for (uint32_t k = 1; k < threadCount; k++) {
+        Queue& victim = queues[(thread + k) % threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.head < victim.tail) {
+            range = victim.ranges[--victim.tail];
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::drain(uint32_t thread)
+{
+    Range range;
+    while (popRange(thread, range))
+        kernel(context, range.begin, range.end, thread);
+}
@@ -7,7 +7,6 @@
 #include "math/Vec2.h"
 #include "math/math_utils.h"
 #include "physics/physicsWorld.h"
-#include "deque"
 #include "game/objects.h"
 #include "test/tests.h"
 
@@ -20,9 +19,8 @@ void restitutionTest() {
     const float WALL_THICKNESS = 20.f;
     const float RADIUS = 40.f;
     const float FIXED_DT = 1.f / 60.f;
-    static float accumulator = 0.f;
-    std::deque<Ball> balls;
-    std::deque<Rectangle> rectangles;
+    std::vector<Ball> balls;
+    std::vector<Rectangle> rectangles;
 
 
     sf::RenderWindow window(
@@ -33,6 +31,7 @@ void restitutionTest() {
 
     PhysicsWorld world;
     world.gravity = {0.f, 800.f};
+    world.fixedTimeStep = FIXED_DT;
 
     // No Restitution
     addBall(
@@ -115,26 +114,18 @@ void restitutionTest() {
                 window.close();
             }
         }
-        // ---------- Delta time ----------
-        accumulator += clock.restart().asSeconds();
-
-        while (accumulator >= FIXED_DT) {
-            world.step(FIXED_DT);
-            accumulator -= FIXED_DT;
-        }
+        // ---------- Physics ----------
+        world.advance(clock.restart().asSeconds());
 
         // ---------- Update ----------
         for (auto& ball : balls) {
-            ball.shape.setPosition({
-                ball.body.position.x,
-                ball.body.position.y
-            });
+            Vec2 pos = world.getInterpolatedPosition(ball.body);
+            ball.shape.setPosition({ pos.x, pos.y });
         }
         for (auto& rect : rectangles) {
-            rect.shape.setPosition({
-                rect.body.position.x,
-                rect.body.position.y
-            });
+            Vec2 pos = world.getInterpolatedPosition(rect.body);
+            rect.shape.setPosition({ pos.x, pos.y });
+            rect.shape.setRotation(sf::radians(world.getInterpolatedRotation(rect.body)));
         }
 
         